@@ -0,0 +1,41 @@
+# Writes a C++ source embedding every asset as a read-only, page aligned array plus a path table sorted for lookup
+# Usage: cmake -DOUTPUT=<file.cpp> -DASSET_NAMES=<name|...> -DASSET_FILES=<file|...> -P EmbedAssets.cmake
+string(REPLACE "|" ";" ASSET_NAMES "${ASSET_NAMES}")
+string(REPLACE "|" ";" ASSET_FILES "${ASSET_FILES}")
+
+list(LENGTH ASSET_NAMES ASSET_COUNT)
+
+# The table is sorted by name for binary search, every name keeps its file through the unsorted index
+set(SORTED_NAMES ${ASSET_NAMES})
+list(SORT SORTED_NAMES)
+
+set(ARRAYS "")
+set(TABLE "")
+set(INDEX 0)
+foreach(ASSET_NAME ${SORTED_NAMES})
+    list(FIND ASSET_NAMES "${ASSET_NAME}" ASSET_INDEX)
+    list(GET ASSET_FILES ${ASSET_INDEX} ASSET_FILE)
+
+    file(READ "${ASSET_FILE}" ASSET_HEX HEX)
+    string(LENGTH "${ASSET_HEX}" ASSET_HEX_LENGTH)
+    math(EXPR ASSET_SIZE "${ASSET_HEX_LENGTH} / 2")
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," ASSET_BYTES "${ASSET_HEX}")
+    string(REGEX REPLACE "((0x..,){32})" "\\1\n" ASSET_BYTES "${ASSET_BYTES}")
+
+    # One extra zero byte keeps empty files legal C++
+    string(APPEND ARRAYS "alignas(4096) static const unsigned char asset${INDEX}[] = {\n${ASSET_BYTES}0x00\n};\n\n")
+    string(APPEND TABLE "\t{ \"${ASSET_NAME}\", asset${INDEX}, ${ASSET_SIZE} },\n")
+    math(EXPR INDEX "${INDEX} + 1")
+endforeach()
+
+file(WRITE "${OUTPUT}.tmp"
+"// Generated by cmake/EmbedAssets.cmake, do not edit\n"
+"#include <asset_files.hpp>\n\n"
+"namespace opengles_workspace\n{\n"
+"${ARRAYS}"
+"extern const EmbeddedAsset embeddedAssets[] = {\n${TABLE}};\n"
+"extern const size_t embeddedAssetCount = ${ASSET_COUNT};\n"
+"}\n")
+# Only touch the source when it changed, an unchanged asset set recompiles nothing; file(COPY_FILE) would need CMake 3.21
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different "${OUTPUT}.tmp" "${OUTPUT}")
+file(REMOVE "${OUTPUT}.tmp")
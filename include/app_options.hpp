@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+
+#include <frame_pacer.hpp>
+#include <render_options.hpp>
+
+namespace opengles_workspace
+{
+	struct AppOptions
+	{
+		// Render into an invisible OSMesa window instead of a visible one
+		bool headless = false;
+		// Composite frames on the CPU without any GL context, implies the scripted headless run
+		bool software = false;
+		// Number of scripted frames to render in headless & software mode
+		int frames = 1;
+		// Directory the headless & software frames are written to as PNG, nothing is written if empty
+		// Screenshots & recordings of the windowed run go here too, or to the working directory if empty
+		std::string captureDir;
+		// Palette file the shape masks are coloured with, the embedded one if empty
+		std::string palettePath;
+		// Seed for the board colours, random if not set
+		bool hasSeed = false;
+		unsigned int seed = 0;
+		// Swap interval & pacing of the windowed run
+		PresentOptions present;
+		// How the GL renderer draws the board
+		RenderOptions render;
+		// Chrome trace_event JSON file the profiler writes on exit, profiling is off if empty
+		std::string tracePath;
+
+		static AppOptions Parse(int argc, char** argv);
+	};
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace opengles_workspace
+{
+	// Read-only view of a file embedded into the executable, data is null if there is no such file
+	struct AssetFile
+	{
+		const unsigned char* data;
+		size_t size;
+	};
+
+	// Entry of the table generated by cmake/EmbedAssets.cmake, sorted by path
+	struct EmbeddedAsset
+	{
+		const char* path;
+		const unsigned char* data;
+		size_t size;
+	};
+
+	// Look up an embedded file by its path relative to the source tree, e.g. "font/font.ttf"
+	AssetFile OpenAsset(const std::string& path);
+}
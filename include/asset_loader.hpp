@@ -0,0 +1,61 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <shape.hpp>
+#include <shape_palette.hpp>
+#include <baked_texture.hpp>
+#include <asset_files.hpp>
+
+namespace opengles_workspace
+{
+	// Greyscale levels of one mask, the whole mip chain if it was baked offline, else only the full size level
+	struct TextureImage
+	{
+		// Empty if the texture could not be loaded
+		std::vector<TextureLevel> levels;
+
+		// Pixels of a decoded image, baked levels point straight into the embedded asset
+		std::vector<unsigned char> decoded;
+	};
+
+	// Reads the embedded shape masks, decoding them on a worker pool from construction on if they were not baked
+	class AssetLoader
+	{
+	public:
+		// The palette is read from palettePath, or the embedded one if empty, throws Exception if it cannot be read or parsed
+		AssetLoader(const std::string& palettePath = "");
+
+		// Waits for the workers, assets that were never asked for are discarded
+		~AssetLoader();
+
+		// Shape or frame mask of a mask layer, waits until it is loaded
+		const TextureImage& maskImage(int maskLayer);
+
+		// Colours the masks are drawn in
+		const ShapePalette& palette() const { return mPalette; }
+
+		// Embedded font file
+		AssetFile font() const;
+	private:
+		static const int taskCount = Shape::maskLayerCount;
+
+		void work();
+		void runTask(int task);
+		void waitFor(int task);
+
+		std::array<TextureImage, Shape::maskLayerCount> mImages;
+		ShapePalette mPalette;
+
+		std::atomic<int> mNextTask;
+		std::mutex mMutex;
+		std::condition_variable mTaskDone;
+		std::array<bool, taskCount> mDone;
+		std::vector<std::thread> mWorkers;
+	};
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace opengles_workspace
+{
+	// One mip level of 8-bit pixels, rows top first, the caller knows the channel count
+	struct TextureLevel
+	{
+		int width;
+		int height;
+		const unsigned char* pixels;
+	};
+
+	// File layout: header, levelCount level entries, then the pixels of every level at 16 byte aligned offsets
+	struct BakedTextureHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t width;
+		uint32_t height;
+		uint32_t levelCount;
+		// 1 for greyscale masks, 4 for RGBA
+		uint32_t channels;
+	};
+
+	struct BakedTextureLevel
+	{
+		uint32_t width;
+		uint32_t height;
+		uint64_t offset;
+		uint64_t size;
+	};
+
+	// Read the level table of a texture baked offline with the given channel count, the levels point into the data
+	bool ReadBakedTexture(const unsigned char* data, size_t size, int channels, std::vector<TextureLevel>& levels);
+
+	// Bake 8-bit pixels & their box filtered mip chain into a container file
+	bool WriteBakedTexture(const std::string& path, int width, int height, int channels, const unsigned char* pixels);
+}
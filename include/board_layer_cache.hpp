@@ -0,0 +1,47 @@
+#pragma once
+#include <glad/gl.h>
+
+#include <damage_tracker.hpp>
+#include <render_commands.hpp>
+#include <shader.hpp>
+
+namespace opengles_workspace
+{
+	// Keeps the board at rest in a framebuffer sized texture, only the cells that changed are drawn into it again
+	// A frame shows the whole board as one quad copying the texture, whatever it repaints
+	class BoardLayerCache
+	{
+	public:
+		BoardLayerCache(ShaderManager& shaders);
+
+		~BoardLayerCache();
+
+		// Framebuffer pixels the board covers, another size or place draws the whole layer again
+		void setBounds(const DamageRect& bounds, int surfaceWidth, int surfaceHeight);
+
+		// Framebuffer pixels whose board contents changed
+		void invalidate(const DamageRect& rect);
+
+		// Parts of the layer wait to be drawn again
+		bool stale() const { return !mStale.empty(); }
+
+		// Draw the stale parts of the layer with the commands drawing the board into the framebuffer
+		void refresh(GLCommandBackend& backend, const RenderCommandBuffer& boardCommands);
+
+		// Record the quad showing the layer in the board area
+		void record(RenderCommandBuffer& commands);
+	private:
+		GLuint mProgram;
+		GLint mRectLocation;
+		GLuint mFramebuffer;
+		GLuint mTexture;
+		GLuint mQuadVao;
+		GLuint mQuadVbo;
+		GLuint mQuadIbo;
+		DamageRect mBounds;
+		int mSurfaceWidth;
+		int mSurfaceHeight;
+		// Stale rectangles inside the board area, the history is never used
+		DamageTracker mStale;
+	};
+}
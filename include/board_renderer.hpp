@@ -0,0 +1,85 @@
+#pragma once
+#include <array>
+#include <vector>
+
+#include <glad/gl.h>
+
+#include <game_logic.hpp>
+#include <render_commands.hpp>
+#include <shader.hpp>
+#include <asset_loader.hpp>
+#include <layout.hpp>
+
+namespace opengles_workspace
+{
+	class BoardRenderer
+	{
+	public:
+		BoardRenderer(ShaderManager& shaders, AssetLoader& assets);
+
+		~BoardRenderer();
+
+		// Upload only the instance entries whose position, texture layer or motion changed
+		// New motions start animating at time, in seconds on the clock passed to record
+		void update(const GameSnapshot& snapshot, const Layout& layout, float time);
+
+		// Record the cells inside the board area as a single instanced draw command, the shader animates the cells at time
+		void record(RenderCommandBuffer& commands, float time);
+
+		// Cells whose pixels change in the frame of the last update, as row * gameBoardSize + column
+		const std::vector<int>& changedCells() const { return mChangedCells; }
+
+		// Area a cell covers over its whole animation, in normalized device coordinates
+		void cellBounds(int cell, float& leftX, float& topY, float& rightX, float& bottomY) const;
+
+		// Single channel texture array holding every shape & frame mask, shared with the tile map
+		GLuint shapeMasks() const { return mTextureArray; }
+
+		// Some cell is still moving at time
+		bool animating(float time) const { return mAnimationEnd > time; }
+
+		// Move the clock origin forward by offset seconds, keeps times small enough for float precision
+		void rebaseTime(float offset);
+	private:
+		static const int cellCount = GameLogic::gameBoardSize * GameLogic::gameBoardSize;
+
+		// Matches the std140 layout of two vec4 entries in the CellInstances block
+		struct CellInstance
+		{
+			// Where the cell ends up & when it starts moving there
+			GLfloat x;
+			GLfloat y;
+			GLfloat layer;
+			GLfloat startTime;
+			// Where the cell starts from & its size there, relative to a cell
+			GLfloat fromX;
+			GLfloat fromY;
+			GLfloat fromScale;
+			GLfloat padding;
+		};
+
+		GLuint mProgram;
+		GLuint mTextureArray;
+		GLuint mQuadVao;
+		GLuint mQuadVbo;
+		GLuint mQuadIbo;
+		GLuint mInstanceUbo;
+		GLint mCellSizeLocation;
+		GLint mTimeLocation;
+		GLint mViewportLocation;
+		GLint mVisibleCellsLocation;
+		GLint mFlatLocation;
+		float mCellWidth;
+		float mCellHeight;
+		// Board area as left, bottom, right & top, visible cells as first column, first row, columns & rows
+		std::array<float, 4> mViewport;
+		std::array<float, 4> mVisibleCells;
+		bool mFlat;
+		float mLastUpdateTime;
+		float mAnimationEnd;
+
+		std::array<CellInstance, cellCount> mInstances;
+		std::array<unsigned int, cellCount> mMotionSerials;
+		std::vector<int> mChangedCells;
+	};
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+namespace opengles_workspace
+{
+	// Part of the board on screen, in board cells
+	struct CameraView
+	{
+		// 1 fits the whole board into its viewport, larger values magnify
+		float zoom;
+		// Board position shown in the middle of the viewport, in cells from the top left corner
+		float centerColumn;
+		float centerRow;
+	};
+
+	// Zooms & pans over a board, never showing anything beyond its edges
+	class Camera2D
+	{
+	public:
+		Camera2D(int columns, int rows);
+
+		// Magnify by factor around the middle of the view, clamped between the whole board & a few cells
+		void zoomBy(float factor);
+
+		// Move the view by a number of cells, clamped to the board
+		void pan(float columns, float rows);
+
+		// Show the whole board again
+		void reset();
+
+		const CameraView& view() const { return mView; }
+	private:
+		void clampCenter();
+
+		int mColumns;
+		int mRows;
+		CameraView mView;
+	};
+}
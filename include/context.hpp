@@ -1,14 +1,14 @@
-#pragma once
-
-namespace opengles_workspace {
-	class Context
-	{
-	public:
-		Context(void* window)
-			: mWindow(window)
-		{}
-		void* window() const { return mWindow; }
-	private:
-		void* mWindow;
-	};
+#pragma once
+
+namespace opengles_workspace {
+	class Context
+	{
+	public:
+		Context(void* window)
+			: mWindow(window)
+		{}
+		void* window() const { return mWindow; }
+	private:
+		void* mWindow;
+	};
 }
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+#include <deque>
+#include <vector>
+
+namespace opengles_workspace
+{
+	// Rectangle in framebuffer pixels with a bottom left origin, as used by glScissor
+	struct DamageRect
+	{
+		int x;
+		int y;
+		int width;
+		int height;
+	};
+
+	// Collects the regions that changed this frame and remembers those of previous frames
+	class DamageTracker
+	{
+	public:
+		DamageTracker(int historyLength);
+
+		// Framebuffer size, changing it damages the whole frame
+		void resize(int width, int height);
+
+		void addRect(DamageRect rect);
+
+		void addFullFrame();
+
+		bool empty() const { return mFrameDamage.empty(); }
+
+		// Damage of the current frame only, what the platform has to present
+		const std::vector<DamageRect>& frameDamage() const { return mFrameDamage; }
+
+		// Rectangles to repaint into a back buffer that is bufferAge frames old (0 = unknown contents)
+		std::vector<DamageRect> repaintRegion(int bufferAge) const;
+
+		// Move the current damage into history and start a new frame
+		void endFrame();
+	private:
+		static const int maxFrameRects = 16;
+
+		int mHistoryLength;
+		int mWidth;
+		int mHeight;
+		std::vector<DamageRect> mFrameDamage;
+		std::deque<std::vector<DamageRect>> mHistory;
+	};
+}
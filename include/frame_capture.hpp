@@ -0,0 +1,12 @@
+#pragma once
+#include <string>
+#include <vector>
+
+namespace opengles_workspace
+{
+	// Read the current framebuffer as tightly packed RGBA rows, bottom row first
+	void ReadFramebuffer(int width, int height, std::vector<unsigned char>& pixels);
+
+	// Write RGBA pixels as a PNG, rows read back from GL come bottom row first
+	bool WritePng(const std::string& path, int width, int height, const std::vector<unsigned char>& pixels, bool bottomRowFirst = true);
+}
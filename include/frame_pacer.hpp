@@ -0,0 +1,69 @@
+#pragma once
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace opengles_workspace
+{
+	enum class PresentMode
+	{
+		// Swap on every vertical blank, lowest power, up to a refresh of added latency
+		VSYNC,
+		// Swap on the vertical blank unless the frame is late, then tear instead of waiting a whole refresh
+		ADAPTIVE,
+		// Swap immediately, lowest latency, tears & draws as often as frames are submitted
+		UNCAPPED,
+		// Swap immediately but never faster than the frame limit, paced by the CPU
+		LIMITED
+	};
+
+	struct PresentOptions
+	{
+		PresentMode mode = PresentMode::VSYNC;
+		// Frames per second in LIMITED mode
+		int frameLimit = 60;
+		// Record present intervals & input latency and print them on exit
+		bool measure = false;
+
+		// Parse a mode name as given on the command line, throws Exception for unknown names
+		static PresentMode ParseMode(const std::string& name);
+	};
+
+	typedef std::chrono::steady_clock::time_point FrameTime;
+
+	// Set the swap interval for the mode on the current context, ADAPTIVE falls back to VSYNC without tear control
+	void ApplyPresentMode(PresentMode mode);
+
+	// Keeps presents at least one frame period apart, sleeping most of the wait & spinning the rest for precision
+	class FramePacer
+	{
+	public:
+		FramePacer(int framesPerSecond);
+
+		// Block until the next frame may be drawn, returns at once after an idle or late frame
+		void wait();
+	private:
+		std::chrono::nanoseconds mPeriod;
+		FrameTime mNextFrame;
+	};
+
+	// Present-to-present intervals & input-to-photon estimates of a run
+	class PresentStats
+	{
+	public:
+		// scanOutMs estimates how long a presented frame takes to reach the screen, it is added to every input latency
+		PresentStats(double scanOutMs);
+
+		// A frame was presented, input is when the oldest input drawn in it arrived, none if it draws no new input
+		// Intervals only count between back to back frames, idle time between inputs says nothing about pacing
+		void presented(std::optional<FrameTime> input, bool backToBack);
+
+		void print() const;
+	private:
+		double mScanOutMs;
+		FrameTime mLastPresent;
+		std::vector<double> mIntervalsMs;
+		std::vector<double> mInputLatenciesMs;
+	};
+}
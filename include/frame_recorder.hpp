@@ -0,0 +1,94 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glad/gl.h>
+
+namespace opengles_workspace
+{
+	// Screenshots & recordings of the windowed run, read back through a ring of pixel buffers
+	// A frame is read into a buffer without waiting & mapped a few frames later, once the GPU is done with it
+	// PNG & Y4M encoding runs on a thread of its own, the render thread only copies the mapped pixels
+	class FrameRecorder
+	{
+	public:
+		// Files are written to directory, recordings claim framesPerSecond in their header
+		FrameRecorder(std::string directory, int framesPerSecond);
+
+		// Waits for the frames in flight & the encoder, needs the context current
+		~FrameRecorder();
+
+		// Write the next frame read as a PNG
+		void requestScreenshot();
+
+		// Start a new Y4M file or finish the current one
+		void toggleRecording();
+
+		bool recording() const { return mRecording; }
+
+		// A screenshot is waiting or a recording runs, every frame until then has to be drawn & read
+		bool wantsFrame() const { return mScreenshotRequested || mRecording; }
+
+		// Frames were read but not mapped yet
+		bool busy() const { return !mInFlight.empty(); }
+
+		// Start reading the back buffer of a finished frame, before it is presented
+		void readFrame(int width, int height);
+
+		// Hand the frames the GPU finished to the encoder, wait maps every frame in flight
+		void collect(bool wait);
+	private:
+		static const int bufferCount = 3;
+
+		// Pixel buffer of the ring & what the frame read into it is for
+		struct ReadBuffer
+		{
+			GLuint buffer;
+			size_t capacity;
+			GLsync fence;
+			int width;
+			int height;
+			std::string screenshotPath;
+			std::string videoPath;
+			// Reads since this one, mapped without fences once the ring came around
+			int age;
+		};
+
+		// Work for the encoder, a frame for a screenshot, a recording or both, or the end of a recording
+		struct EncodeJob
+		{
+			int width;
+			int height;
+			std::vector<unsigned char> pixels;
+			std::string screenshotPath;
+			std::string videoPath;
+			bool endVideo;
+		};
+
+		std::string nextPath(const char* prefix, const char* extension);
+		void mapOldest();
+		void push(EncodeJob job);
+		void encode();
+
+		std::string mDirectory;
+		int mFramesPerSecond;
+		int mFileCount;
+		bool mScreenshotRequested;
+		bool mRecording;
+		std::string mVideoPath;
+		ReadBuffer mBuffers[bufferCount];
+		int mNextBuffer;
+		// Buffers read & not mapped yet, oldest first
+		std::deque<int> mInFlight;
+
+		std::mutex mMutex;
+		std::condition_variable mCondition;
+		std::deque<EncodeJob> mJobs;
+		bool mStopping;
+		std::thread mEncoder;
+	};
+}
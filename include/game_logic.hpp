@@ -1,4 +1,5 @@
 #include <shape.hpp>
+#include <array>
 
  #ifndef gamelogic
  #define gamelogic
@@ -17,6 +18,20 @@ namespace opengles_workspace
         HORIZONTAL
     };
 
+    struct GameSnapshot;
+
+    // Where the shape shown in a cell came from, so renderers can animate the change
+    struct CellMotion
+    {
+        // Changes with every new motion of the cell, 0 until the first one
+        unsigned int serial;
+        // Cell the shape started from, rows above the board are negative
+        int fromI;
+        int fromJ;
+        // A new shape refilling a cleared match, instead of one moved by a shift
+        bool spawned;
+    };
+
     class GameLogic
     {
     public:
@@ -28,6 +43,11 @@ namespace opengles_workspace
         static int currentJ;
         static int score;
         static bool isSomethingSelected;
+        static CellMotion cellMotions[gameBoardSize][gameBoardSize];
+        static unsigned int motionSerial;
+
+        static void RecordSwap(int, int, int, int);
+        static void RecordSpawn(int, int, int);
 
     public:
         GameLogic();
@@ -38,6 +58,7 @@ namespace opengles_workspace
         static int GetCurrentJ();
         static int GetScore();
         static bool GetSomethingSelectedFlag();
+        static GameSnapshot GetSnapshot();
 
         static void CheckShift(Shape&, Shape&, Direction);
         static void CalculateScore(Shape&, int, int);
@@ -45,6 +66,20 @@ namespace opengles_workspace
 
         static void Move(Direction);
         static void SelectShape();
+        static void PlayScriptedFrame(int);
+    };
+
+    // Immutable copy of everything the renderer needs, safe to hand to another thread
+    struct GameSnapshot
+    {
+        std::array<int, GameLogic::gameBoardSize * GameLogic::gameBoardSize> textureLayers;
+        std::array<CellMotion, GameLogic::gameBoardSize * GameLogic::gameBoardSize> motions;
+        int currentI;
+        int currentJ;
+        int score;
+
+        int GetTextureLayerAt(int i, int j) const { return textureLayers[i * GameLogic::gameBoardSize + j]; }
+        const CellMotion& GetMotionAt(int i, int j) const { return motions[i * GameLogic::gameBoardSize + j]; }
     };
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+#include <vector>
+
+#include <glad/gl.h>
+
+namespace opengles_workspace
+{
+	// Interleaved vertex of a textured quad, position at location 0 & texture coordinates at location 2
+	struct QuadVertex
+	{
+		GLfloat x;
+		GLfloat y;
+		GLfloat u;
+		GLfloat v;
+	};
+
+	GLuint CreateQuadIndexBuffer(int quadCount);
+}
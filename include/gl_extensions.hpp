@@ -0,0 +1,84 @@
+#pragma once
+
+#include <glad/gl.h>
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+#ifndef GL_TIMESTAMP
+#define GL_TIMESTAMP 0x8E28
+#endif
+#ifndef GL_GPU_DISJOINT_EXT
+#define GL_GPU_DISJOINT_EXT 0x8FBB
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif
+#ifndef GL_ALREADY_SIGNALED
+#define GL_ALREADY_SIGNALED 0x911A
+#endif
+#ifndef GL_TIMEOUT_EXPIRED
+#define GL_TIMEOUT_EXPIRED 0x911B
+#endif
+#ifndef GL_CONDITION_SATISFIED
+#define GL_CONDITION_SATISFIED 0x911C
+#endif
+#ifndef GL_WAIT_FAILED
+#define GL_WAIT_FAILED 0x911D
+#endif
+
+namespace opengles_workspace
+{
+	typedef void (GLAD_API_PTR *PFNGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+	typedef void (GLAD_API_PTR *PFNPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+	typedef void (GLAD_API_PTR *PFNPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+	typedef void (GLAD_API_PTR *PFNQUERYCOUNTERPROC)(GLuint id, GLenum target);
+	typedef void (GLAD_API_PTR *PFNGETQUERYOBJECTUI64VPROC)(GLuint id, GLenum pname, GLuint64* params);
+	typedef void (GLAD_API_PTR *PFNGETINTEGER64VPROC)(GLenum pname, GLint64* data);
+	typedef GLsync (GLAD_API_PTR *PFNFENCESYNCPROC)(GLenum condition, GLbitfield flags);
+	typedef GLenum (GLAD_API_PTR *PFNCLIENTWAITSYNCPROC)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+	typedef void (GLAD_API_PTR *PFNDELETESYNCPROC)(GLsync sync);
+
+	// Entry points the generated GL 3.1 loader does not cover, null when the driver lacks them
+	struct GLExtensions
+	{
+		// GL 4.1, GLES 3.0 or ARB_get_program_binary
+		bool programBinary = false;
+		PFNGETPROGRAMBINARYPROC GetProgramBinary = nullptr;
+		PFNPROGRAMBINARYPROC ProgramBinary = nullptr;
+		PFNPROGRAMPARAMETERIPROC ProgramParameteri = nullptr;
+
+		// GL 3.3, ARB_timer_query or EXT_disjoint_timer_query on GLES
+		bool timerQuery = false;
+		// Only EXT_disjoint_timer_query reports GL_GPU_DISJOINT_EXT
+		bool timerQueryDisjoint = false;
+		PFNQUERYCOUNTERPROC QueryCounter = nullptr;
+		PFNGETQUERYOBJECTUI64VPROC GetQueryObjectui64v = nullptr;
+		PFNGETINTEGER64VPROC GetInteger64v = nullptr;
+
+		// GL 3.2, GLES 3.0 or ARB_sync
+		bool sync = false;
+		PFNFENCESYNCPROC FenceSync = nullptr;
+		PFNCLIENTWAITSYNCPROC ClientWaitSync = nullptr;
+		PFNDELETESYNCPROC DeleteSync = nullptr;
+	};
+
+	// Resolve the extension entry points of the current context, after gladLoadGL
+	void LoadGLExtensions(GLADloadfunc load);
+
+	const GLExtensions& GetGLExtensions();
+
+	// True if the current context is at least the given desktop GL or GLES version
+	bool HasGLVersion(int desktopMajor, int desktopMinor, int esMajor, int esMinor);
+
+	bool HasGLExtension(const char* name);
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+
+#include <glad/gl.h>
+
+namespace opengles_workspace
+{
+	// Calls that reached the driver & calls dropped because they would not have changed anything
+	struct GLStateCounters
+	{
+		uint64_t issued = 0;
+		uint64_t skipped = 0;
+	};
+
+	// Shadow copy of the GL state the renderer touches, calls setting what is already set never reach the driver
+	// Every bind, enable & deletion in the context has to go through the cache, or the cache has to be invalidated
+	class GLStateCache
+	{
+	public:
+		GLStateCache();
+
+		// Forget the shadowed state, the next call of every kind reaches the driver
+		void invalidate();
+
+		void useProgram(GLuint program);
+
+		// Set a float uniform of the current program, 1 to 4 components
+		void uniform(GLint location, GLint components, const GLfloat* values);
+
+		// Bind a texture to a unit, selecting the unit first if needed
+		void bindTexture(GLuint unit, GLenum target, GLuint texture);
+
+		// Element buffers are vertex array state, they are bound directly while creating the vertex array
+		void bindBuffer(GLenum target, GLuint buffer);
+
+		// Also sets the generic binding of the target, like GL does
+		void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+		void bindVertexArray(GLuint vertexArray);
+
+		// Binds GL_FRAMEBUFFER, drawing & reading alike
+		void bindFramebuffer(GLuint framebuffer);
+
+		// Enabled attributes are remembered per vertex array
+		void enableVertexAttribArray(GLuint index);
+
+		// GL_BLEND & GL_SCISSOR_TEST are shadowed, other capabilities always reach the driver
+		void setEnabled(GLenum capability, bool enabled);
+		void blendFunc(GLenum source, GLenum destination);
+		void scissor(GLint x, GLint y, GLsizei width, GLsizei height);
+		void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+		// Deleting unbinds the objects, so a recycled name is never taken for bound
+		void deleteProgram(GLuint program);
+		void deleteTextures(GLsizei count, const GLuint* textures);
+		void deleteBuffers(GLsizei count, const GLuint* buffers);
+		void deleteVertexArrays(GLsizei count, const GLuint* vertexArrays);
+		void deleteFramebuffers(GLsizei count, const GLuint* framebuffers);
+
+		const GLStateCounters& counters() const { return mCounters; }
+		void resetCounters() { mCounters = GLStateCounters(); }
+	private:
+		static const int textureUnitCount = 4;
+		// GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY & GL_TEXTURE_3D
+		static const int textureTargetCount = 3;
+		// GL_ARRAY_BUFFER, GL_UNIFORM_BUFFER, GL_PIXEL_PACK_BUFFER & GL_PIXEL_UNPACK_BUFFER
+		static const int bufferTargetCount = 4;
+		static const int uniformBindingCount = 4;
+
+		// Counts the call & returns true if it can be skipped
+		bool unchanged(bool same);
+
+		GLStateCounters mCounters;
+		GLuint mProgram;
+		GLuint mActiveUnit;
+		std::array<std::array<GLuint, textureTargetCount>, textureUnitCount> mTextures;
+		std::array<GLuint, bufferTargetCount> mBuffers;
+		std::array<GLuint, uniformBindingCount> mUniformBindings;
+		GLuint mVertexArray;
+		GLuint mFramebuffer;
+		// Enabled attribute bits of every vertex array seen
+		std::unordered_map<GLuint, uint32_t> mEnabledAttributes;
+		// Values of every float uniform set, by program & location
+		std::unordered_map<uint64_t, std::array<GLfloat, 4>> mUniforms;
+		int mBlend;
+		int mScissorTest;
+		std::array<GLenum, 2> mBlendFunc;
+		std::array<GLint, 4> mScissor;
+		std::array<GLint, 4> mViewport;
+	};
+
+	// Cache of the context current on the calling thread
+	GLStateCache& GetGLState();
+}
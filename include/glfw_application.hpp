@@ -1,17 +1,24 @@
-#pragma once
-
-#include <cstdlib>
-
-namespace opengles_workspace
-{
-class GlfwApplication
-{
-public:
-    GlfwApplication(size_t width, size_t height);
-    ~GlfwApplication();
-    int run();
-private:
-    size_t mWidth;
-    size_t mHeight;
-};
+#pragma once
+
+#include <cstdlib>
+#include <memory>
+
+#include <app_options.hpp>
+#include <asset_loader.hpp>
+
+namespace opengles_workspace
+{
+class GlfwApplication
+{
+public:
+    GlfwApplication(size_t width, size_t height, AppOptions options = AppOptions());
+    ~GlfwApplication();
+    int run();
+private:
+    int runHeadless(std::shared_ptr<AssetLoader> assets);
+
+    size_t mWidth;
+    size_t mHeight;
+    AppOptions mOptions;
+};
 }
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+#include <unordered_map>
+
+#include <glad/gl.h>
+
+#include <asset_files.hpp>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+namespace opengles_workspace
+{
+	// Signed distance fields of glyphs, generated once from FreeType outlines and packed into one shared texture
+	// Texels hold 0.5 on the outline, more inside & less outside, so one small atlas draws text sharply at any size
+	class GlyphAtlas
+	{
+	public:
+		// Size the distance fields are generated at, glyph sizes are in pixels of this size
+		static const int pixelSize = 32;
+		// Distance in pixels covered by the field on either side of the outline, also the padding around each glyph
+		static const int spread = 4;
+
+		struct Glyph
+		{
+			// Size of the field, the glyph bitmap plus the spread on every side
+			int width;
+			int rows;
+			// Atlas texture coordinates of the bitmap, top left & bottom right
+			float leftU;
+			float topV;
+			float rightU;
+			float bottomV;
+		};
+
+		// FreeType reads glyphs from the font file on demand, embedded assets live as long as the program
+		GlyphAtlas(AssetFile font);
+
+		~GlyphAtlas();
+
+		// Glyph of the character, its distance field is generated into the atlas on first use
+		const Glyph& glyph(unsigned long charCode);
+
+		GLuint texture() const { return mTexture; }
+	private:
+		static const int atlasSize = 256;
+		static const int glyphPadding = 1;
+		// Glyphs are rasterised this many times larger than the field, the outline is found to a fraction of a field pixel
+		static const int supersampling = 4;
+
+		FT_Library mLibrary;
+		FT_Face mFace;
+		GLuint mTexture;
+
+		// Shelf packing cursor
+		int mPenX;
+		int mPenY;
+		int mShelfHeight;
+
+		std::unordered_map<unsigned long, Glyph> mGlyphs;
+	};
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include <glad/gl.h>
+
+#include <profiler.hpp>
+
+namespace opengles_workspace
+{
+	// Times GL work with timestamp queries & records it on a "GPU" track once the results arrived, a few frames later
+	class GpuProfiler
+	{
+	public:
+		// Does nothing unless the profiler is enabled & the driver has timer queries
+		GpuProfiler();
+
+		~GpuProfiler();
+
+		// Mark the start of a zone in the command stream, -1 if it is not timed
+		int beginZone(const char* name);
+
+		void endZone(int zone);
+
+		// Record the zones the GPU has finished, never waits for it, called once a frame
+		void collect();
+	private:
+		struct Zone
+		{
+			const char* name;
+			GLuint begin;
+			GLuint end;
+		};
+
+		GLuint acquireQuery();
+		void calibrate();
+
+		bool mEnabled;
+		ProfileTrack* mTrack;
+		// Zones in submission order, the front one finishes first
+		std::deque<Zone> mZones;
+		int mFirstZone;
+		std::vector<GLuint> mFreeQueries;
+		std::vector<GLuint> mQueries;
+		// Profiler::Now() minus the GPU clock
+		int64_t mClockOffset;
+		int mCollectsSinceCalibration;
+	};
+
+	// Times the GL commands issued during the lifetime of the scope
+	class GpuProfileZone
+	{
+	public:
+		GpuProfileZone(GpuProfiler& profiler, const char* name)
+			: mProfiler(profiler)
+			, mZone(profiler.beginZone(name))
+		{
+		}
+
+		~GpuProfileZone()
+		{
+			mProfiler.endZone(mZone);
+		}
+
+		GpuProfileZone(const GpuProfileZone&) = delete;
+		GpuProfileZone& operator=(const GpuProfileZone&) = delete;
+	private:
+		GpuProfiler& mProfiler;
+		int mZone;
+	};
+}
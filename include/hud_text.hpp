@@ -0,0 +1,55 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include <glad/gl.h>
+
+#include <geometry.hpp>
+#include <glyph_atlas.hpp>
+#include <render_commands.hpp>
+#include <sprite_batch.hpp>
+
+namespace opengles_workspace
+{
+	// Text elements whose laid-out quads are kept until their text changes & streamed through a sprite batch when recorded
+	class HudText
+	{
+	public:
+		HudText(GlyphAtlas& glyphs, SpriteBatch& sprites, int maxLabels, int maxLabelLength);
+
+		// Add a label whose characters are centered in consecutive cells of the given size
+		int addLabel(float x, float y, float cellWidth, float cellHeight);
+
+		// Move a label, only its own quads are laid out again
+		void moveLabel(int label, float x, float y, float cellWidth, float cellHeight);
+
+		// Normalized device size of one glyph bitmap pixel, lays out every label again
+		void setGlyphScale(float glyphScaleX, float glyphScaleY);
+
+		// Re-layout the label only if the text actually changed
+		void setText(int label, const std::string& text);
+
+		// Record every label as one draw command from the cached quads, the caller fences the batch once it is submitted
+		void record(RenderCommandBuffer& commands, GLuint program);
+	private:
+		struct Label
+		{
+			float x;
+			float y;
+			float cellWidth;
+			float cellHeight;
+			std::string text;
+		};
+
+		void layout(int label);
+
+		GlyphAtlas& mGlyphs;
+		SpriteBatch& mSprites;
+		int mMaxLabels;
+		int mMaxLabelLength;
+		float mGlyphScaleX;
+		float mGlyphScaleY;
+		std::vector<Label> mLabels;
+		std::vector<QuadVertex> mVertices;
+	};
+}
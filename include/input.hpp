@@ -1,43 +1,56 @@
-#pragma once
-#include <polled_object.hpp>
-#include <context.hpp>
-#include <memory>
-#include <functional>
-
-namespace opengles_workspace {
-	enum class Key
-	{
-		ESCAPE = 0,
-		LEFT,
-		DOWN,
-		RIGHT,
-		SPACE,
-		W,
-		A,
-		S,
-		D,
-		E
-	};
-
-	enum class KeyMode
-	{
-		PRESS,
-		RELEASE
-	};
-
-	class Input : public PolledObject
-	{
-	public:
-		typedef std::function<bool(Key, KeyMode)> KeyCallback;
-
-		Input(std::shared_ptr<Context> context)
-			: mContext(std::move(context))
-		{}
-
-		virtual void registerKeyCallback(KeyCallback keyCallback) = 0;
-
-		static std::unique_ptr<Input> create(std::shared_ptr<Context> context);
-	protected:
-		std::shared_ptr<Context> mContext;
-	};
+#pragma once
+#include <polled_object.hpp>
+#include <context.hpp>
+#include <layout.hpp>
+#include <memory>
+#include <functional>
+
+namespace opengles_workspace {
+	enum class Key
+	{
+		ESCAPE = 0,
+		LEFT,
+		DOWN,
+		RIGHT,
+		SPACE,
+		W,
+		A,
+		S,
+		D,
+		E,
+		UP,
+		PLUS,
+		MINUS,
+		ZERO,
+		F9,
+		F12
+	};
+
+	enum class KeyMode
+	{
+		PRESS,
+		RELEASE
+	};
+
+	class Input : public PolledObject
+	{
+	public:
+		typedef std::function<bool(Key, KeyMode)> KeyCallback;
+		typedef std::function<void(const SurfaceSize&)> ResizeCallback;
+
+		Input(std::shared_ptr<Context> context)
+			: mContext(std::move(context))
+		{}
+
+		virtual void registerKeyCallback(KeyCallback keyCallback) = 0;
+
+		// Called when the framebuffer size or the content scale of the window changes
+		virtual void registerResizeCallback(ResizeCallback resizeCallback) = 0;
+
+		virtual SurfaceSize surfaceSize() const = 0;
+
+		static std::unique_ptr<Input> create(std::shared_ptr<Context> context);
+	protected:
+		std::shared_ptr<Context> mContext;
+	};
 }
\ No newline at end of file
@@ -0,0 +1,98 @@
+#pragma once
+#include <camera.hpp>
+
+namespace opengles_workspace
+{
+	// Framebuffer size in pixels & the content scale of the monitor the window is on
+	struct SurfaceSize
+	{
+		int width;
+		int height;
+		float contentScale;
+	};
+
+	// Placement of the score & board, shared by every renderer backend
+	// The board lives on a grid of square, whole-pixel cells letterboxed into the framebuffer, so it never stretches
+	class Layout
+	{
+	public:
+		static const int maxHudLabelLength = 16;
+		// Below this many pixels per board cell the shapes are too small to tell apart
+		static const int minShapePixels = 12;
+
+		Layout();
+
+		// Recompute the geometry, false if nothing changed
+		bool resize(const SurfaceSize& size);
+
+		// Show the part of the board the camera looks at, false if nothing changed
+		bool setView(const CameraView& view);
+
+		const SurfaceSize& surface() const { return mSurface; }
+
+		// Size of one step of the layout grid in framebuffer pixels, a board cell when the whole board is shown
+		int cellPixels() const { return mCellPixels; }
+
+		// Size of one step of the layout grid in normalized device coordinates
+		float cellWidth() const { return mCellWidth; }
+		float cellHeight() const { return mCellHeight; }
+
+		// Size of one board cell through the camera, in framebuffer pixels & normalized device coordinates
+		float tilePixels() const { return mCellPixels * mView.zoom; }
+		float tileWidth() const { return mTileWidth; }
+		float tileHeight() const { return mTileHeight; }
+
+		// Board cells are too small on screen for their shapes, renderers draw them in a flat colour instead
+		bool flatTiles() const { return tilePixels() < minShapePixels; }
+
+		// Top left corner of a board cell through the camera in normalized device coordinates
+		float cellX(int column) const { return mViewX + mTileWidth * column; }
+		float cellY(int row) const { return mViewY - mTileHeight * row; }
+
+		// Area the board is drawn into in normalized device coordinates, cells beyond it are culled or clipped
+		float boardLeft() const { return mBoardX; }
+		float boardTop() const { return mBoardY; }
+		float boardRight() const { return mBoardRight; }
+		float boardBottom() const { return mBoardBottom; }
+
+		// Board cells at least partly inside the board area
+		int firstVisibleColumn() const { return mFirstVisibleColumn; }
+		int firstVisibleRow() const { return mFirstVisibleRow; }
+		int visibleColumns() const { return mVisibleColumns; }
+		int visibleRows() const { return mVisibleRows; }
+
+		// Top left corner of the score label, its characters take one cell each
+		float scoreX() const { return mScoreX; }
+		float scoreY() const { return mScoreY; }
+
+		// Size text is shown at in framebuffer pixels
+		float textPixelSize() const { return mTextPixelSize; }
+
+		// Normalized device size of one pixel of a glyph rasterised at glyphPixelSize
+		float glyphScaleX(int glyphPixelSize) const { return mTextPixelSize / glyphPixelSize * 2.0f / mSurface.width; }
+		float glyphScaleY(int glyphPixelSize) const { return mTextPixelSize / glyphPixelSize * 2.0f / mSurface.height; }
+	private:
+		void applyView();
+
+		SurfaceSize mSurface;
+		CameraView mView;
+		int mCellPixels;
+		float mCellWidth;
+		float mCellHeight;
+		float mBoardX;
+		float mBoardY;
+		float mBoardRight;
+		float mBoardBottom;
+		float mTileWidth;
+		float mTileHeight;
+		float mViewX;
+		float mViewY;
+		int mFirstVisibleColumn;
+		int mFirstVisibleRow;
+		int mVisibleColumns;
+		int mVisibleRows;
+		float mScoreX;
+		float mScoreY;
+		float mTextPixelSize;
+	};
+}
@@ -1,12 +1,12 @@
-#pragma once
-
-namespace opengles_workspace 
-{
-	class PolledObject 
-	{
-	public:
-		virtual ~PolledObject() {}
-
-		virtual bool poll() = 0;
-	};
+#pragma once
+
+namespace opengles_workspace 
+{
+	class PolledObject 
+	{
+	public:
+		virtual ~PolledObject() {}
+
+		virtual bool poll() = 0;
+	};
 }
\ No newline at end of file
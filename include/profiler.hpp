@@ -0,0 +1,95 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace opengles_workspace
+{
+	// One finished zone, times in nanoseconds since the profiler was enabled
+	struct ProfileEvent
+	{
+		const char* name;
+		int64_t start;
+		int64_t duration;
+	};
+
+	// Events of one thread or GPU queue, appended by a single writer without locks & read when the trace is written
+	class ProfileTrack
+	{
+	public:
+		ProfileTrack(std::string name, uint32_t id, uint32_t capacity);
+
+		// Drops the event once the track is full, a trace never reallocates under a running frame
+		void record(const char* name, int64_t start, int64_t duration);
+
+		const std::string& name() const { return mName; }
+		uint32_t id() const { return mId; }
+		uint32_t size() const { return mCount.load(std::memory_order_acquire); }
+		uint32_t dropped() const { return mDropped.load(std::memory_order_relaxed); }
+		const ProfileEvent& event(uint32_t index) const { return mEvents[index]; }
+	private:
+		std::string mName;
+		uint32_t mId;
+		uint32_t mCapacity;
+		std::unique_ptr<ProfileEvent[]> mEvents;
+		std::atomic<uint32_t> mCount;
+		std::atomic<uint32_t> mDropped;
+	};
+
+	// Collects CPU & GPU zones of every thread and writes them as Chrome trace_event JSON
+	class Profiler
+	{
+	public:
+		// Start recording, zones are no-ops until then
+		static void Enable();
+		static bool IsEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+		// Nanoseconds since the profiler was enabled
+		static int64_t Now();
+
+		// Track of the calling thread, created on first use
+		static ProfileTrack& ThreadTrack();
+
+		// Name shown for the calling thread in the trace, costs nothing while the profiler is disabled
+		static void SetThreadName(const char* name);
+
+		// Extra track that is not tied to a thread, e.g. the GPU timeline
+		static ProfileTrack& CreateTrack(const char* name);
+
+		// Write every track recorded so far, loadable by chrome://tracing & Perfetto
+		static bool WriteTrace(const std::string& path);
+	private:
+		static std::atomic<bool> enabled;
+	};
+
+	// Records the lifetime of the scope as a zone of the calling thread
+	class ProfileZone
+	{
+	public:
+		explicit ProfileZone(const char* name)
+			: mName(name)
+			, mStart(Profiler::IsEnabled() ? Profiler::Now() : -1)
+		{
+		}
+
+		~ProfileZone()
+		{
+			if(mStart >= 0)
+			{
+				Profiler::ThreadTrack().record(mName, mStart, Profiler::Now() - mStart);
+			}
+		}
+
+		ProfileZone(const ProfileZone&) = delete;
+		ProfileZone& operator=(const ProfileZone&) = delete;
+	private:
+		const char* mName;
+		int64_t mStart;
+	};
+}
+
+#define PROFILE_ZONE_CONCAT_INNER(a, b) a##b
+#define PROFILE_ZONE_CONCAT(a, b) PROFILE_ZONE_CONCAT_INNER(a, b)
+// Profile the rest of the enclosing scope under a string literal name
+#define PROFILE_ZONE(name) ::opengles_workspace::ProfileZone PROFILE_ZONE_CONCAT(profileZone, __LINE__)(name)
@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <glad/gl.h>
+
+namespace opengles_workspace
+{
+	// Coarse draw order, commands are never reordered across layers
+	enum class RenderLayer : uint8_t
+	{
+		BOARD = 0,
+		HUD
+	};
+
+	struct UniformCommand
+	{
+		GLint location;
+		GLint components;
+		GLfloat values[4];
+	};
+
+	// Everything needed to issue one indexed draw, recorded instead of calling GL directly
+	struct DrawCommand
+	{
+		uint64_t sortKey;
+		RenderLayer layer;
+		GLuint program;
+		GLenum textureTarget;
+		GLuint texture;
+		// GL_TEXTURE_2D bound to texture unit 1 for lookups by the shader, 0 for none
+		GLuint lookupTexture;
+		// Bound to uniform block binding 0, 0 for none
+		GLuint uniformBuffer;
+		GLuint vertexArray;
+		GLenum mode;
+		// Number of GL_UNSIGNED_SHORT indices, starting at index first of the element buffer
+		GLsizei count;
+		GLsizei first;
+		// Instances to draw, 0 skips the command
+		GLsizei instanceCount;
+		UniformCommand* uniforms;
+		uint32_t uniformCount;
+	};
+
+	// Bump allocator for data that only lives until the end of the frame
+	class FrameArena
+	{
+	public:
+		FrameArena(size_t capacity);
+
+		template<typename T>
+		T* allocate(size_t count)
+		{
+			return static_cast<T*>(allocateBytes(sizeof(T) * count, alignof(T)));
+		}
+
+		void reset() { mUsed = 0; }
+	private:
+		void* allocateBytes(size_t size, size_t alignment);
+
+		std::unique_ptr<unsigned char[]> mMemory;
+		size_t mCapacity;
+		size_t mUsed;
+	};
+
+	class RenderCommandBuffer
+	{
+	public:
+		RenderCommandBuffer(size_t arenaCapacity, size_t maxCommands);
+
+		// Drop the previous frame's commands
+		void reset();
+
+		// Record a draw with room for the given number of uniform values, fields are filled in by the caller
+		DrawCommand& addDraw(RenderLayer layer, uint32_t uniformCount = 0);
+
+		// Order commands by layer, then program, texture & vertex array so the backend changes state as little as possible
+		void sort();
+
+		const std::vector<DrawCommand*>& commands() const { return mCommands; }
+	private:
+		FrameArena mArena;
+		size_t mMaxCommands;
+		std::vector<DrawCommand*> mCommands;
+	};
+
+	// Submits recorded commands to GL, skipping binds that would not change anything
+	class GLCommandBackend
+	{
+	public:
+		void submit(const RenderCommandBuffer& commands);
+	};
+}
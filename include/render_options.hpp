@@ -0,0 +1,15 @@
+#pragma once
+
+namespace opengles_workspace
+{
+	// How the GL renderer draws the frame
+	struct RenderOptions
+	{
+		// Draw the board as one quad looking its cells up in an index texture instead of one instance per cell
+		bool tileMap = false;
+		// Keep the board at rest in an offscreen layer, redrawn only where cells changed
+		bool boardCache = true;
+		// Print the GL state calls per frame on exit, with those the state cache skipped
+		bool glStats = false;
+	};
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <memory>
+#include <optional>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <exception>
+
+#include <context.hpp>
+#include <polled_object.hpp>
+#include <game_logic.hpp>
+#include <asset_loader.hpp>
+#include <frame_pacer.hpp>
+#include <layout.hpp>
+#include <camera.hpp>
+#include <render_options.hpp>
+
+namespace opengles_workspace
+{
+	// Owns the GL context and the renderer, drawing the latest submitted snapshot off the input thread
+	class RenderThread : public PolledObject
+	{
+	public:
+		// Screenshots & recordings are written to captureDir
+		RenderThread(std::shared_ptr<Context> context, std::shared_ptr<AssetLoader> assets, const SurfaceSize& size, PresentOptions present, RenderOptions render,
+			std::string captureDir);
+
+		~RenderThread();
+
+		// Hand over the latest game state, replacing any snapshot that was not drawn yet
+		void submit(const GameSnapshot& snapshot);
+
+		// Hand over a new framebuffer size, the latest snapshot is drawn again at that size
+		void resize(const SurfaceSize& size);
+
+		// Hand over a new camera view, the latest snapshot is drawn again through it
+		void setView(const CameraView& view);
+
+		// Save the next frame as a PNG, drawn even if nothing changed
+		void screenshot();
+
+		// Start or stop writing every frame to a Y4M file, frames are drawn at the present rate while recording
+		void toggleRecording();
+
+		bool poll() override;
+	private:
+		void run();
+
+		std::shared_ptr<Context> mContext;
+		std::shared_ptr<AssetLoader> mAssets;
+		PresentOptions mPresent;
+		RenderOptions mRender;
+		double mScanOutMs;
+		std::string mCaptureDir;
+		// Frame rate written into recordings
+		int mRecordRate;
+		std::mutex mMutex;
+		std::condition_variable mCondition;
+		SurfaceSize mSize;
+		std::optional<GameSnapshot> mPendingSnapshot;
+		std::optional<SurfaceSize> mPendingSize;
+		std::optional<CameraView> mPendingView;
+		bool mPendingScreenshot;
+		bool mPendingRecordToggle;
+		// Arrival of the oldest input the pending snapshot contains
+		FrameTime mPendingInput;
+		bool mStopping;
+		std::exception_ptr mError;
+		std::thread mThread;
+	};
+}
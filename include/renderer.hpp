@@ -1,32 +1,104 @@
-#pragma once
-#include <memory>
-#include <optional>
-#include <context.hpp>
-#include <polled_object.hpp>
-
-#include <glad/gl.h>
-#define GLFW_INCLUDE_NONE
-#include <GLFW/glfw3.h>
-
-#include <game_logic.hpp>
-
-namespace opengles_workspace
-{
-class GLFWRenderer : public PolledObject
-	{
-	public:
-		GLFWRenderer(std::shared_ptr<Context> context);
-
-		~GLFWRenderer() = default;
-
-		void render();
-
-		void renderOnlyCursor(Direction);
-
-		bool poll() override;
-	private:
-
-		std::shared_ptr<Context> mContext;
-		GLFWwindow* window() const { return static_cast<GLFWwindow*>(mContext->window()); }
-	};
+#pragma once
+#include <memory>
+#include <optional>
+#include <functional>
+#include <context.hpp>
+#include <polled_object.hpp>
+
+#include <glad/gl.h>
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+#include <game_logic.hpp>
+#include <board_renderer.hpp>
+#include <tile_map_renderer.hpp>
+#include <board_layer_cache.hpp>
+#include <glyph_atlas.hpp>
+#include <sprite_batch.hpp>
+#include <hud_text.hpp>
+#include <damage_tracker.hpp>
+#include <surface_presenter.hpp>
+#include <render_commands.hpp>
+#include <shader.hpp>
+#include <asset_loader.hpp>
+#include <gpu_profiler.hpp>
+#include <gl_state_cache.hpp>
+#include <layout.hpp>
+#include <render_options.hpp>
+
+namespace opengles_workspace
+{
+class GLFWRenderer : public PolledObject
+	{
+	public:
+		GLFWRenderer(std::shared_ptr<Context> context, std::shared_ptr<AssetLoader> assets, const SurfaceSize& size, const RenderOptions& options);
+
+		~GLFWRenderer() = default;
+
+		typedef std::function<void(int, int)> FrameCallback;
+		// Seconds on a monotonic clock
+		typedef std::function<double()> Clock;
+
+		// Redraw only what changed since the previous frame, false if nothing changed & no frame was presented
+		bool render(const GameSnapshot& snapshot);
+
+		// Lay the frame out for a new framebuffer size, the next frame is drawn in full
+		void resize(const SurfaceSize& size);
+
+		// Show the part of the board the camera looks at
+		void setView(const CameraView& view);
+
+		// Called with the framebuffer size once a frame is drawn, before it is presented
+		void setFrameCallback(FrameCallback frameCallback) { mFrameCallback = std::move(frameCallback); }
+
+		// Clock the animations run on, the steady clock unless frames are rendered on a script
+		void setClock(Clock clock) { mClock = std::move(clock); mTimeBase = mClock(); }
+
+		// Draw the whole frame on the next render, even if nothing changed
+		void redraw() { mDamage.addFullFrame(); }
+
+		// Cells are still moving, frames have to keep coming even without new snapshots
+		bool animating() const { return !mTileMap && mBoard.animating(mFrameTime); }
+
+		// Average GL state calls per presented frame, issued & skipped by the state cache
+		void printGLStats() const;
+
+		bool poll() override;
+	private:
+
+		std::shared_ptr<Context> mContext;
+		std::shared_ptr<AssetLoader> mAssets;
+		ShaderManager mShaders;
+		Layout mLayout;
+		BoardRenderer mBoard;
+		// Draws the board instead of mBoard when set, without animations
+		std::unique_ptr<TileMapRenderer> mTileMap;
+		// Shows the board at rest from an offscreen layer when set, the board is drawn directly while it animates
+		std::unique_ptr<BoardLayerCache> mBoardLayer;
+		GlyphAtlas mGlyphs;
+		// Quads streamed anew every frame, fenced once the frame is submitted
+		SpriteBatch mSprites;
+		HudText mHud;
+		int mScoreLabel;
+		int mShownScore;
+		DamageTracker mDamage;
+		SurfacePresenter mPresenter;
+		RenderCommandBuffer mCommands;
+		// The board alone, drawn into the board layer
+		RenderCommandBuffer mBoardCommands;
+		GLCommandBackend mBackend;
+		FrameCallback mFrameCallback;
+		Clock mClock;
+		double mTimeBase;
+		float mFrameTime;
+		GpuProfiler mGpuProfiler;
+		GLuint mTextProgram;
+		GLStateCounters mGLTotals;
+		int mGLFrames;
+
+		DamageRect NdcToPixelRect(float leftX, float topY, float rightX, float bottomY) const;
+		void recordBoard(RenderCommandBuffer& commands);
+		void addBoardDamage(float leftX, float topY, float rightX, float bottomY);
+		GLFWwindow* window() const { return static_cast<GLFWwindow*>(mContext->window()); }
+	};
 }
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include <glad/gl.h>
+
+namespace opengles_workspace
+{
+	// Compiles & links programs, reusing linked program binaries from an on-disk cache where the driver supports it
+	class ShaderManager
+	{
+	public:
+		ShaderManager();
+
+		// Deletes every program created through the manager
+		~ShaderManager();
+
+		// Linked program for the sources, throws Exception with the info log if compiling or linking fails
+		GLuint createProgram(const char* vertexSource, const char* fragmentSource);
+	private:
+		GLuint loadCachedProgram(const std::string& path);
+		void storeCachedProgram(const std::string& path, GLuint program);
+
+		// Empty if program binaries are unsupported or there is nowhere to store them
+		std::string mCacheDirectory;
+		// Identifies the driver the binaries were produced by, they are useless to any other
+		std::string mDriver;
+		std::vector<GLuint> mPrograms;
+	};
+}
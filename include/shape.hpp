@@ -26,6 +26,14 @@
 
         class Shape
         {
+        public:
+            const static int colourCount = PINK + 1;
+            const static int statusCount = SELECTED + 1;
+            // Colour & status pairs a cell can show
+            const static int textureLayerCount = colourCount * statusCount;
+            // Greyscale masks, the shape of every colour followed by the cell frame of every status
+            const static int maskLayerCount = colourCount + statusCount;
+
         private:
             ShapeColour shapeColour;
             ShapeStatus shapeStatus;
@@ -34,13 +42,18 @@
             Shape();
             ~Shape() {};
 
+            static void SeedRandom(unsigned int);
+
             ShapeColour GetColour();
             ShapeStatus GetStatus();
             void SetColour(ShapeColour);
             void SetRandomColour();
             void SetStatus(ShapeStatus);
             const char* GetColourAsString();
-            std::string GetTexturePath();
+            static std::string GetColourName(ShapeColour);
+            static std::string GetStatusName(ShapeStatus);
+            static std::string GetMaskName(int);
+            int GetTextureLayer();
         };
     }
  #endif
\ No newline at end of file
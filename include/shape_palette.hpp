@@ -0,0 +1,34 @@
+#pragma once
+#include <array>
+#include <string>
+
+#include <glad/gl.h>
+
+#include <shape.hpp>
+
+namespace opengles_workspace
+{
+	// 8-bit red, green & blue
+	using PaletteColour = std::array<unsigned char, 3>;
+
+	// Colours the greyscale masks are drawn in, read from a text file so new colours & colour-blind palettes need no new textures
+	// A shape mask fades the outline in over the first half of its range & blends it into the fill over the second, the frame mask goes on top in its tint
+	struct ShapePalette
+	{
+		std::array<PaletteColour, Shape::colourCount> outlines;
+		std::array<PaletteColour, Shape::colourCount> fills;
+		std::array<PaletteColour, Shape::statusCount> frames;
+
+		// Pixel of a colour & status pair from its shape & frame mask values, the same as the shaders compute
+		PaletteColour colour(int textureLayer, unsigned char shapeMask, unsigned char frameMask) const;
+	};
+
+	// Parse the lines of a palette file, throws Exception naming source on malformed lines or missing entries
+	ShapePalette ParseShapePalette(const std::string& text, const std::string& source);
+
+	// GLSL declaring the palette uniforms, CellMaskLayers & ColourCell, to follow the precision statements of a fragment shader
+	std::string ShapePaletteShader();
+
+	// Set the uniforms declared by ShapePaletteShader, the program is left in use
+	void SetShapePaletteUniforms(GLuint program, const ShapePalette& palette);
+}
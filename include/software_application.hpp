@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdlib>
+
+#include <app_options.hpp>
+
+namespace opengles_workspace
+{
+class SoftwareApplication
+{
+public:
+    SoftwareApplication(size_t width, size_t height, AppOptions options);
+    int run();
+private:
+    size_t mWidth;
+    size_t mHeight;
+    AppOptions mOptions;
+};
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+
+#include <game_logic.hpp>
+#include <asset_loader.hpp>
+#include <shape.hpp>
+#include <layout.hpp>
+
+namespace opengles_workspace
+{
+	// Composites the board & score into an RGBA framebuffer on the CPU, without any GL context
+	class SoftwareRenderer
+	{
+	public:
+		SoftwareRenderer(int width, int height, AssetLoader& assets);
+
+		~SoftwareRenderer();
+
+		// Draw the whole frame from the snapshot
+		void render(const GameSnapshot& snapshot);
+
+		// Tightly packed RGBA pixels of the last frame, top row first
+		const std::vector<unsigned char>& pixels() const { return mPixels; }
+		int width() const { return mWidth; }
+		int height() const { return mHeight; }
+	private:
+		// 8-bit coverage bitmap of one character, rasterised at the framebuffer scale
+		struct GlyphBitmap
+		{
+			int width;
+			int rows;
+			std::vector<unsigned char> coverage;
+		};
+
+		void loadTiles(AssetLoader& assets);
+		const GlyphBitmap& glyph(unsigned long charCode);
+		void drawText(const std::string& text, float x, float y, float cellWidth, float cellHeight);
+		int ndcToColumn(float x) const;
+		int ndcToRow(float y) const;
+
+		int mWidth;
+		int mHeight;
+		std::vector<unsigned char> mPixels;
+		Layout mLayout;
+
+		// Every colour & status pair coloured once from its masks & scaled to the size of a board cell
+		int mTileWidth;
+		int mTileHeight;
+		std::array<std::vector<uint32_t>, Shape::textureLayerCount> mTiles;
+
+		FT_Library mLibrary;
+		FT_Face mFace;
+		std::unordered_map<unsigned long, GlyphBitmap> mGlyphs;
+	};
+}
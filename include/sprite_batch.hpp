@@ -0,0 +1,60 @@
+#pragma once
+#include <vector>
+
+#include <glad/gl.h>
+
+#include <render_commands.hpp>
+
+namespace opengles_workspace
+{
+	// Vertex of a batched quad, position at location 0 & texture coordinates plus array layer at location 2
+	// Programs sampling 2D textures read location 2 as a vec2 & ignore the layer
+	struct SpriteVertex
+	{
+		GLfloat x;
+		GLfloat y;
+		GLfloat u;
+		GLfloat v;
+		GLfloat layer;
+	};
+
+	// Streams quads that change from frame to frame into a ring of vertex buffer regions, written through glMapBufferRange
+	// Every batch takes the next region unsynchronized, fences keep it from overwriting a region the GPU still reads
+	class SpriteBatch
+	{
+	public:
+		// Room for maxQuads per batch & regionCount batches in flight, 65536 vertices at most
+		SpriteBatch(int maxQuads, int regionCount);
+
+		~SpriteBatch();
+
+		// Map the next region, only waits when the GPU is still reading it from regionCount batches ago
+		void begin();
+
+		// Write a quad straight into the mapped region, false once the batch is full
+		bool addQuad(float leftX, float topY, float rightX, float bottomY,
+			float leftU = 0.0f, float topV = 0.0f, float rightU = 1.0f, float bottomV = 1.0f, float layer = 0.0f);
+
+		// Unmap the region & record its quads as one draw, the caller sets program, textures & uniforms
+		// Null if the batch is empty
+		DrawCommand* record(RenderCommandBuffer& commands, RenderLayer layer, uint32_t uniformCount = 0);
+
+		// Fence the batches recorded since the last fence, once their draws were submitted
+		void fence();
+	private:
+		void unmap();
+
+		int mMaxQuads;
+		int mRegionCount;
+		GLuint mVao;
+		GLuint mVbo;
+		GLuint mIbo;
+		// Region of the current batch & its mapping, null while unmapped
+		int mRegion;
+		SpriteVertex* mVertices;
+		int mQuadCount;
+		// One fence per region, shared by every region fenced at once, null once the GPU is done with it
+		std::vector<GLsync> mFences;
+		std::vector<int> mUnfencedRegions;
+	};
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <vector>
+
+#include <damage_tracker.hpp>
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+namespace opengles_workspace
+{
+	// Presents frames with partial-update swaps when the context runs on EGL with buffer age / swap with damage
+	class SurfacePresenter
+	{
+	public:
+		SurfacePresenter(GLFWwindow* window);
+
+		// Frames since the current back buffer was presented, 0 if its contents are undefined
+		int bufferAge();
+
+		// Swap buffers, telling the platform which part of the frame changed if it can use that
+		void present(const std::vector<DamageRect>& damage);
+	private:
+		GLFWwindow* mWindow;
+		void* mDisplay;
+		void* mSurface;
+		bool mHasBufferAge;
+		void* mSwapBuffersWithDamage;
+	};
+}
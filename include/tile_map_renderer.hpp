@@ -0,0 +1,84 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <glad/gl.h>
+
+#include <game_logic.hpp>
+#include <render_commands.hpp>
+#include <shader.hpp>
+#include <shape_palette.hpp>
+#include <layout.hpp>
+
+namespace opengles_workspace
+{
+	// Draws a grid of shape tiles as a single quad, the fragment shader looks each cell up in an 8-bit index texture
+	// The cost of a frame follows the pixels covered, not the cell count, & changing cells only uploads their texels
+	class TileMapRenderer
+	{
+	public:
+		// Cells are coloured from the masks of shapeMasks with palette
+		// Larger than GL_MAX_TEXTURE_SIZE in either direction throws Exception
+		TileMapRenderer(ShaderManager& shaders, GLuint shapeMasks, const ShapePalette& palette, int columns, int rows);
+
+		~TileMapRenderer();
+
+		// Change the colour & status pair of one cell, uploaded on the next flush
+		void setCell(int row, int column, uint8_t layer);
+
+		// Upload the rectangle spanning every cell set since the last flush
+		void flush();
+
+		// Area the whole map covers, in normalized device coordinates
+		void setBounds(float leftX, float topY, float width, float height);
+
+		// Rectangle the map is clipped to, the whole framebuffer by default
+		void setViewport(float leftX, float topY, float rightX, float bottomY);
+
+		// Draw every cell in the average colour of its shape, for cells too small to show it
+		void setFlat(bool flat) { mFlat = flat; }
+
+		// Set every cell from the game board, placed by the layout, & flush
+		void update(const GameSnapshot& snapshot, const Layout& layout);
+
+		// Record the map as one draw command
+		void record(RenderCommandBuffer& commands);
+
+		// Cells changed by the last update, as row * columns + column
+		// Empty with allChanged set once too many changed to be worth tracking one by one
+		const std::vector<int>& changedCells() const { return mChangedCells; }
+		bool allChanged() const { return mAllChanged; }
+	private:
+		int mColumns;
+		int mRows;
+		GLuint mProgram;
+		GLuint mShapeMasks;
+		GLuint mIndexTexture;
+		GLuint mQuadVao;
+		GLuint mQuadVbo;
+		GLuint mQuadIbo;
+		GLint mOriginLocation;
+		GLint mSizeLocation;
+		GLint mGridLocation;
+		GLint mViewportLocation;
+		GLint mFlatLocation;
+		float mLeftX;
+		float mTopY;
+		float mWidth;
+		float mHeight;
+		// Left, bottom, right & top
+		std::array<float, 4> mViewport;
+		bool mFlat;
+
+		// Copy of the index texture, the source of the partial uploads
+		std::vector<uint8_t> mCells;
+		// Cells changed since the last flush, in cells, empty while dirtyRight <= dirtyLeft
+		int mDirtyLeft;
+		int mDirtyTop;
+		int mDirtyRight;
+		int mDirtyBottom;
+		std::vector<int> mChangedCells;
+		bool mAllChanged;
+	};
+}
@@ -1,11 +1,36 @@
-#include <stdio.h>
-#include <cassert>
-#include "glfw_application.hpp"
-
-using namespace opengles_workspace;
-
-int main()
-{
-    GlfwApplication app(640, 640);
-    return app.run();
+#include <stdio.h>
+#include <cassert>
+#include "glfw_application.hpp"
+#include "software_application.hpp"
+#include "profiler.hpp"
+
+using namespace opengles_workspace;
+
+int main(int argc, char** argv)
+{
+    AppOptions options = AppOptions::Parse(argc, argv);
+    if (!options.tracePath.empty())
+    {
+        Profiler::Enable();
+        Profiler::SetThreadName("main");
+    }
+
+    int result = 0;
+    if (options.software)
+    {
+        SoftwareApplication app(640, 640, options);
+        result = app.run();
+    }
+    else
+    {
+        GlfwApplication app(640, 640, options);
+        result = app.run();
+    }
+
+    // Every other thread has been joined by now
+    if (!options.tracePath.empty())
+    {
+        Profiler::WriteTrace(options.tracePath);
+    }
+    return result;
 }
\ No newline at end of file
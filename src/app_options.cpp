@@ -0,0 +1,72 @@
+#include <app_options.hpp>
+#include <exception.hpp>
+
+#include <cstdlib>
+
+namespace opengles_workspace
+{
+	/// @brief Parse a whole number option value
+	/// @param option option name for the error message
+	/// @param value option value
+	/// @param minimum smallest accepted value
+	/// @return Number, throws Exception on malformed or too small values
+	static long ParseNumber(const std::string& option, const char* value, long minimum = 0)
+	{
+		char* end = nullptr;
+		long number = strtol(value, &end, 10);
+		if (end == value || *end != '\0' || number < minimum) {
+			throw Exception("Invalid value for " + option + ": " + value);
+		}
+		return number;
+	}
+
+	/// @brief Parse command line options
+	/// @param argc argument count
+	/// @param argv arguments
+	/// @return Parsed options, throws Exception on unknown options or missing values
+	AppOptions AppOptions::Parse(int argc, char** argv)
+	{
+		AppOptions options;
+		// The environment lets deployed builds be traced without changing how they are launched
+		if (const char* trace = getenv("SHAPESHIFTER_TRACE")) {
+			options.tracePath = trace;
+		}
+		for (int i = 1; i < argc; i++) {
+			std::string option = argv[i];
+			bool hasValue = i + 1 < argc;
+			if (option == "--headless") {
+				options.headless = true;
+			} else if (option == "--software") {
+				options.software = true;
+			} else if (option == "--frames" && hasValue) {
+				options.frames = (int)ParseNumber(option, argv[++i]);
+			} else if (option == "--capture-dir" && hasValue) {
+				options.captureDir = argv[++i];
+			} else if (option == "--palette" && hasValue) {
+				options.palettePath = argv[++i];
+			} else if (option == "--seed" && hasValue) {
+				options.seed = (unsigned int)ParseNumber(option, argv[++i]);
+				options.hasSeed = true;
+			} else if (option == "--present" && hasValue) {
+				options.present.mode = PresentOptions::ParseMode(argv[++i]);
+			} else if (option == "--frame-limit" && hasValue) {
+				// Recordings are written at the frame limit, a limit of 0 would stall the pacer & the Y4M frame rate
+				options.present.frameLimit = (int)ParseNumber(option, argv[++i], 1);
+				options.present.mode = PresentMode::LIMITED;
+			} else if (option == "--pacing-stats") {
+				options.present.measure = true;
+			} else if (option == "--tile-map") {
+				options.render.tileMap = true;
+			} else if (option == "--no-board-cache") {
+				options.render.boardCache = false;
+			} else if (option == "--gl-stats") {
+				options.render.glStats = true;
+			} else if (option == "--trace" && hasValue) {
+				options.tracePath = argv[++i];
+			} else {
+				throw Exception("Unknown or incomplete option: " + option);
+			}
+		}
+		return options;
+	}
+}
@@ -0,0 +1,25 @@
+#include <asset_files.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace opengles_workspace
+{
+	extern const EmbeddedAsset embeddedAssets[];
+	extern const size_t embeddedAssetCount;
+
+	/// @brief Find an embedded file, without any filesystem access
+	/// @param path path relative to the source tree, e.g. "images/shape_red.png"
+	/// @return View of the file contents, data is null if the file was not embedded
+	AssetFile OpenAsset(const std::string& path)
+	{
+		const EmbeddedAsset* end = embeddedAssets + embeddedAssetCount;
+		const EmbeddedAsset* asset = std::lower_bound(embeddedAssets, end, path.c_str(),
+			[](const EmbeddedAsset& entry, const char* name) { return strcmp(entry.path, name) < 0; });
+		if(asset == end || path != asset->path)
+		{
+			return { nullptr, 0 };
+		}
+		return { asset->data, asset->size };
+	}
+}
@@ -0,0 +1,134 @@
+#include <asset_loader.hpp>
+
+#include <exception.hpp>
+#include <profiler.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "stb_image.h"
+
+namespace opengles_workspace
+{
+	const char* fontPath = "font/font.ttf";
+	const char* embeddedPalettePath = "images/palette.txt";
+
+	/// @brief Read the palette & start decoding the masks
+	/// @param palettePath palette file on disk, the embedded palette if empty
+	AssetLoader::AssetLoader(const std::string& palettePath)
+		: mNextTask(0)
+	{
+		mDone.fill(false);
+
+		// Before the workers start, a bad palette must not leave threads behind
+		if(palettePath.empty())
+		{
+			AssetFile file = OpenAsset(embeddedPalettePath);
+			if(!file.data)
+			{
+				throw Exception(std::string("Palette [") + embeddedPalettePath + "] was not embedded");
+			}
+			mPalette = ParseShapePalette(std::string((const char*)file.data, file.size), embeddedPalettePath);
+		}
+		else
+		{
+			std::ifstream file(palettePath, std::ios::binary);
+			std::ostringstream text;
+			text << file.rdbuf();
+			if(!file)
+			{
+				throw Exception("Could not read palette [" + palettePath + "]");
+			}
+			mPalette = ParseShapePalette(text.str(), palettePath);
+		}
+
+		// Never more workers than assets, one is enough to move decoding off the caller
+		unsigned int workerCount = std::max(1u, std::min(std::thread::hardware_concurrency(), (unsigned int)taskCount));
+		for(unsigned int worker = 0; worker < workerCount; worker++)
+		{
+			mWorkers.emplace_back(&AssetLoader::work, this);
+		}
+	}
+
+	AssetLoader::~AssetLoader()
+	{
+		for(std::thread& worker : mWorkers)
+		{
+			worker.join();
+		}
+	}
+
+	/// @brief Worker loop, takes the next task until none are left
+	void AssetLoader::work()
+	{
+		Profiler::SetThreadName("asset worker");
+		for(int task = mNextTask++; task < taskCount; task = mNextTask++)
+		{
+			runTask(task);
+
+			std::lock_guard<std::mutex> lock(mMutex);
+			mDone[task] = true;
+			mTaskDone.notify_all();
+		}
+	}
+
+	/// @brief Load one mask
+	/// @param task mask layer
+	void AssetLoader::runTask(int task)
+	{
+		std::string name = Shape::GetMaskName(task);
+		TextureImage& image = mImages[task];
+		PROFILE_ZONE("load texture");
+
+		// Baked textures need no decoding, their levels are read in place
+		AssetFile baked = OpenAsset("baked/" + name + ".tex");
+		if(ReadBakedTexture(baked.data, baked.size, 1, image.levels))
+		{
+			return;
+		}
+
+		std::string path = "images/" + name + ".png";
+		AssetFile file = OpenAsset(path);
+		int width, height, nrChannels;
+		unsigned char *data = file.data ? stbi_load_from_memory(file.data, (int)file.size, &width, &height, &nrChannels, 1) : nullptr;
+		if(!data)
+		{
+			printf("Failed to load texture at [%s]\n", path.c_str());
+			return;
+		}
+		image.decoded.assign(data, data + (size_t)width * height);
+		image.levels.push_back({ width, height, image.decoded.data() });
+		stbi_image_free(data);
+	}
+
+	/// @brief Block until a task has finished
+	/// @param task mask layer
+	void AssetLoader::waitFor(int task)
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		mTaskDone.wait(lock, [this, task] { return mDone[task]; });
+	}
+
+	/// @brief Get a loaded mask
+	/// @param maskLayer shape mask of a colour, or frame mask of a status after Shape::colourCount
+	/// @return Greyscale levels, none if loading failed
+	const TextureImage& AssetLoader::maskImage(int maskLayer)
+	{
+		waitFor(maskLayer);
+		return mImages[maskLayer];
+	}
+
+	/// @brief Get the embedded font file
+	/// @return Font bytes, data is null if the font was not embedded
+	AssetFile AssetLoader::font() const
+	{
+		AssetFile file = OpenAsset(fontPath);
+		if(!file.data)
+		{
+			fprintf(stderr, "Could not open font [%s]\n", fontPath);
+		}
+		return file;
+	}
+}
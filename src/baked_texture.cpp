@@ -0,0 +1,122 @@
+#include <baked_texture.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace opengles_workspace
+{
+	const uint32_t bakedTextureMagic = 0x58545353;	// "SSTX"
+	const uint32_t bakedTextureVersion = 2;
+	const uint64_t bakedTextureAlignment = 16;
+
+	static uint64_t AlignOffset(uint64_t offset)
+	{
+		return (offset + bakedTextureAlignment - 1) & ~(bakedTextureAlignment - 1);
+	}
+
+	/// @brief Validate a baked texture and list its levels, nothing is copied
+	/// @param data container contents, e.g. an embedded asset
+	/// @param size container size in bytes
+	/// @param channels channels per pixel the caller expects
+	/// @param levels receives the levels from the full size down to 1x1
+	/// @return true if the container is valid & has the expected channels
+	bool ReadBakedTexture(const unsigned char* data, size_t size, int channels, std::vector<TextureLevel>& levels)
+	{
+		levels.clear();
+		if(!data || size < sizeof(BakedTextureHeader))
+		{
+			return false;
+		}
+
+		BakedTextureHeader header;
+		memcpy(&header, data, sizeof(header));
+		size_t tableEnd = sizeof(header) + (size_t)header.levelCount * sizeof(BakedTextureLevel);
+		if(header.magic != bakedTextureMagic || header.version != bakedTextureVersion || header.levelCount == 0
+			|| header.channels != (uint32_t)channels || tableEnd > size)
+		{
+			return false;
+		}
+
+		for(uint32_t index = 0; index < header.levelCount; index++)
+		{
+			BakedTextureLevel level;
+			memcpy(&level, data + sizeof(header) + index * sizeof(level), sizeof(level));
+			if(level.size != (uint64_t)level.width * level.height * channels || level.offset > size || level.size > size - level.offset)
+			{
+				levels.clear();
+				return false;
+			}
+			levels.push_back({ (int)level.width, (int)level.height, data + level.offset });
+		}
+		return true;
+	}
+
+	/// @brief Write a baked texture, each mip level is a 2x2 box filter of the previous one
+	/// @param path container file to write
+	/// @param width width of the full size level
+	/// @param height height of the full size level
+	/// @param channels channels per pixel, 1 to 4
+	/// @param pixels 8-bit pixels of the full size level, rows top first
+	/// @return true if the file was written
+	bool WriteBakedTexture(const std::string& path, int width, int height, int channels, const unsigned char* pixels)
+	{
+		std::vector<std::vector<unsigned char>> levels;
+		levels.emplace_back(pixels, pixels + (size_t)width * height * channels);
+		std::vector<BakedTextureLevel> table = { { (uint32_t)width, (uint32_t)height, 0, (uint64_t)width * height * channels } };
+
+		while(table.back().width > 1 || table.back().height > 1)
+		{
+			const BakedTextureLevel& parent = table.back();
+			const std::vector<unsigned char>& source = levels.back();
+			int levelWidth = std::max(1, (int)parent.width / 2);
+			int levelHeight = std::max(1, (int)parent.height / 2);
+
+			std::vector<unsigned char> level((size_t)levelWidth * levelHeight * channels);
+			for(int row = 0; row < levelHeight; row++)
+			{
+				for(int column = 0; column < levelWidth; column++)
+				{
+					// Odd or 1 pixel parents repeat their last row or column
+					int rows[2] = { std::min(row * 2, (int)parent.height - 1), std::min(row * 2 + 1, (int)parent.height - 1) };
+					int columns[2] = { std::min(column * 2, (int)parent.width - 1), std::min(column * 2 + 1, (int)parent.width - 1) };
+					for(int channel = 0; channel < channels; channel++)
+					{
+						int sum = 2;
+						for(int sourceRow : rows)
+						{
+							for(int sourceColumn : columns)
+							{
+								sum += source[((size_t)sourceRow * parent.width + sourceColumn) * channels + channel];
+							}
+						}
+						level[((size_t)row * levelWidth + column) * channels + channel] = (unsigned char)(sum / 4);
+					}
+				}
+			}
+			table.push_back({ (uint32_t)levelWidth, (uint32_t)levelHeight, 0, (uint64_t)level.size() });
+			levels.push_back(std::move(level));
+		}
+
+		BakedTextureHeader header = { bakedTextureMagic, bakedTextureVersion, (uint32_t)width, (uint32_t)height, (uint32_t)table.size(), (uint32_t)channels };
+		uint64_t offset = AlignOffset(sizeof(header) + table.size() * sizeof(BakedTextureLevel));
+		for(BakedTextureLevel& level : table)
+		{
+			level.offset = offset;
+			offset = AlignOffset(offset + level.size);
+		}
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(BakedTextureLevel));
+		uint64_t written = sizeof(header) + table.size() * sizeof(BakedTextureLevel);
+		const char padding[bakedTextureAlignment] = {};
+		for(size_t index = 0; index < table.size(); index++)
+		{
+			file.write(padding, table[index].offset - written);
+			file.write(reinterpret_cast<const char*>(levels[index].data()), levels[index].size());
+			written = table[index].offset + table[index].size;
+		}
+		return (bool)file;
+	}
+}
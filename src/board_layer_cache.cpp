@@ -0,0 +1,177 @@
+#include <board_layer_cache.hpp>
+#include <exception.hpp>
+#include <geometry.hpp>
+#include <gl_state_cache.hpp>
+
+#include <algorithm>
+#include <string>
+
+namespace opengles_workspace
+{
+	char layerVShaderStr[] =
+		"#version 300 es \n"
+		"\n"
+		"layout(location = 0) in vec2 a_corner; \n"
+		"uniform vec4 u_rect; \n"
+		"\n"
+		"void main() \n"
+		"{ \n"
+		" gl_Position = vec4(mix(u_rect.xw, u_rect.zy, a_corner), 0.0, 1.0); \n"
+		"} \n";
+
+	char layerFShaderStr[] =
+		"#version 300 es \n"
+		"precision highp float; \n"
+		"\n"
+		"out vec4 fragColor; \n"
+		"uniform sampler2D layer; \n"
+		"\n"
+		"void main() \n"
+		"{ \n"
+		// One texel per framebuffer pixel, copied without any filtering
+		" fragColor = texelFetch(layer, ivec2(gl_FragCoord.xy), 0); \n"
+		"} \n";
+
+	BoardLayerCache::BoardLayerCache(ShaderManager& shaders)
+		: mBounds({ 0, 0, 0, 0 })
+		, mSurfaceWidth(0)
+		, mSurfaceHeight(0)
+		, mStale(0)
+	{
+		mProgram = shaders.createProgram(layerVShaderStr, layerFShaderStr);
+		mRectLocation = glGetUniformLocation(mProgram, "u_rect");
+
+		glGenTextures(1, &mTexture);
+		GetGLState().bindTexture(0, GL_TEXTURE_2D, mTexture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glGenFramebuffers(1, &mFramebuffer);
+
+		// Static unit quad, corners in 0..1 from the top left of the layer
+		GLfloat corners[] = 	{
+								 0.0f, 0.0f,		// Top left
+								 1.0f, 0.0f,		// Top right
+								 0.0f, 1.0f,		// Bottom left
+								 1.0f, 1.0f		// Bottom right
+								};
+		glGenVertexArrays(1, &mQuadVao);
+		GetGLState().bindVertexArray(mQuadVao);
+		glGenBuffers(1, &mQuadVbo);
+		GetGLState().bindBuffer(GL_ARRAY_BUFFER, mQuadVbo);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+		glVertexAttribPointer ( 0, 2, GL_FLOAT, GL_FALSE, 0, nullptr );
+		GetGLState().enableVertexAttribArray(0);
+		mQuadIbo = CreateQuadIndexBuffer(1);
+		GetGLState().bindVertexArray(0);
+		GetGLState().bindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	BoardLayerCache::~BoardLayerCache()
+	{
+		GetGLState().deleteFramebuffers(1, &mFramebuffer);
+		GetGLState().deleteTextures(1, &mTexture);
+		GetGLState().deleteBuffers(1, &mQuadIbo);
+		GetGLState().deleteBuffers(1, &mQuadVbo);
+		GetGLState().deleteVertexArrays(1, &mQuadVao);
+	}
+
+	/// @brief Place the layer, reallocating its texture when the framebuffer size changed
+	/// @param bounds board area in framebuffer pixels, bottom left origin
+	/// @param surfaceWidth framebuffer width
+	/// @param surfaceHeight framebuffer height
+	void BoardLayerCache::setBounds(const DamageRect& bounds, int surfaceWidth, int surfaceHeight)
+	{
+		if(bounds.x == mBounds.x && bounds.y == mBounds.y && bounds.width == mBounds.width && bounds.height == mBounds.height
+			&& surfaceWidth == mSurfaceWidth && surfaceHeight == mSurfaceHeight)
+		{
+			return;
+		}
+
+		// A minimised window reports an empty framebuffer, the texture is kept & the board is drawn into it again once the window is back
+		if(surfaceWidth == 0 || surfaceHeight == 0)
+		{
+			mBounds = bounds;
+			return;
+		}
+
+		// The layer matches the framebuffer pixel for pixel, the board rasterises exactly as it would on screen
+		if(surfaceWidth != mSurfaceWidth || surfaceHeight != mSurfaceHeight)
+		{
+			GetGLState().bindTexture(0, GL_TEXTURE_2D, mTexture);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, surfaceWidth, surfaceHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+			GetGLState().bindFramebuffer(mFramebuffer);
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mTexture, 0);
+			GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+			GetGLState().bindFramebuffer(0);
+			if(status != GL_FRAMEBUFFER_COMPLETE)
+			{
+				throw Exception("Board layer framebuffer of " + std::to_string(surfaceWidth) + "x" + std::to_string(surfaceHeight)
+					+ " is incomplete, status=" + std::to_string(status));
+			}
+		}
+		mBounds = bounds;
+		mSurfaceWidth = surfaceWidth;
+		mSurfaceHeight = surfaceHeight;
+		// Resizing stales the whole framebuffer, only the board area has to be drawn
+		mStale.resize(surfaceWidth, surfaceHeight);
+		mStale.endFrame();
+		invalidate(bounds);
+	}
+
+	/// @brief Mark part of the board to be drawn into the layer again
+	/// @param rect framebuffer pixels
+	void BoardLayerCache::invalidate(const DamageRect& rect)
+	{
+		// Only the board area of the layer is ever drawn or shown
+		int left = std::max(rect.x, mBounds.x);
+		int bottom = std::max(rect.y, mBounds.y);
+		int right = std::min(rect.x + rect.width, mBounds.x + mBounds.width);
+		int top = std::min(rect.y + rect.height, mBounds.y + mBounds.height);
+		if(right > left && top > bottom)
+		{
+			mStale.addRect({ left, bottom, right - left, top - bottom });
+		}
+	}
+
+	/// @brief Redraw the stale rectangles of the layer
+	/// @param backend submits the board commands
+	/// @param boardCommands sorted commands drawing the board
+	void BoardLayerCache::refresh(GLCommandBackend& backend, const RenderCommandBuffer& boardCommands)
+	{
+		if(!stale())
+		{
+			return;
+		}
+		GLStateCache& state = GetGLState();
+		state.bindFramebuffer(mFramebuffer);
+		state.setEnabled(GL_SCISSOR_TEST, true);
+		for(const DamageRect& rect : mStale.frameDamage())
+		{
+			state.scissor(rect.x, rect.y, rect.width, rect.height);
+			glClear ( GL_COLOR_BUFFER_BIT );
+			backend.submit(boardCommands);
+		}
+		state.setEnabled(GL_SCISSOR_TEST, false);
+		state.bindFramebuffer(0);
+		mStale.endFrame();
+	}
+
+	void BoardLayerCache::record(RenderCommandBuffer& commands)
+	{
+		float leftX = mBounds.x * 2.0f / mSurfaceWidth - 1.0f;
+		float bottomY = mBounds.y * 2.0f / mSurfaceHeight - 1.0f;
+		float rightX = (mBounds.x + mBounds.width) * 2.0f / mSurfaceWidth - 1.0f;
+		float topY = (mBounds.y + mBounds.height) * 2.0f / mSurfaceHeight - 1.0f;
+
+		DrawCommand& command = commands.addDraw(RenderLayer::BOARD, 1);
+		command.program = mProgram;
+		command.textureTarget = GL_TEXTURE_2D;
+		command.texture = mTexture;
+		command.vertexArray = mQuadVao;
+		command.mode = GL_TRIANGLES;
+		command.count = 6;
+		command.uniforms[0] = { mRectLocation, 4, { leftX, bottomY, rightX, topY } };
+	}
+}
@@ -0,0 +1,343 @@
+#include <board_renderer.hpp>
+#include <shader.hpp>
+#include <geometry.hpp>
+#include <gl_state_cache.hpp>
+#include <shape_palette.hpp>
+
+#include <algorithm>
+#include <string>
+#include <cstdio>
+
+namespace opengles_workspace
+{
+	const int shapeTextureSize = 64;
+	// Length of a swap, fall or refill animation
+	const float cellAnimationSeconds = 0.2f;
+	// Start time of cells that are not animated, long enough ago for any animation to be over
+	const float restingStartTime = -1000.0f;
+
+	static std::string BoardVertexShader(int boardSize)
+	{
+		int cellCount = boardSize * boardSize;
+		return
+			"#version 300 es \n"
+			"\n"
+			"layout(location = 0) in vec2 a_corner; \n"
+			"layout(std140) uniform CellInstances \n"
+			"{ \n"
+			" vec4 u_cells[" + std::to_string(cellCount * 2) + "]; \n"
+			"}; \n"
+			"uniform vec2 u_cellSize; \n"
+			"uniform float u_time; \n"
+			"uniform vec4 u_viewport; \n"
+			"uniform vec3 u_visibleCells; \n"
+			"out vec3 v_textures; \n"
+			"\n"
+			"void main() \n"
+			"{ \n"
+			// Instances only cover the visible rectangle of cells, given by its first column, first row & width
+			" int columns = int(u_visibleCells.z); \n"
+			" int index = (int(u_visibleCells.y) + gl_InstanceID / columns) * " + std::to_string(boardSize) + " \n"
+			"  + int(u_visibleCells.x) + gl_InstanceID % columns; \n"
+			" vec4 cell = u_cells[index * 2]; \n"
+			" vec4 from = u_cells[index * 2 + 1]; \n"
+			" float t = clamp((u_time - cell.w) / " + std::to_string(cellAnimationSeconds) + ", 0.0, 1.0); \n"
+			" t = t * t * (3.0 - 2.0 * t); \n"
+			" float scale = mix(from.z, 1.0, t); \n"
+			" vec2 corner = (a_corner - 0.5) * scale + 0.5; \n"
+			" vec2 position = mix(from.xy, cell.xy, t) + vec2(corner.x, -corner.y) * u_cellSize; \n"
+			// Cells on the edge of the board area are cut off, moving the texture coordinates along with the corners
+			" vec2 clipped = clamp(position, u_viewport.xy, u_viewport.zw); \n"
+			" vec2 size = max(u_cellSize * scale, vec2(1e-6)); \n"
+			" gl_Position = vec4(clipped, 0.0, 1.0); \n"
+			" v_textures = vec3(a_corner + (clipped - position) / size * vec2(1.0, -1.0), cell.z); \n"
+			"} \n";
+	}
+
+	static std::string BoardFragmentShader()
+	{
+		return
+			"#version 300 es \n"
+			"precision mediump float; \n"
+			"precision mediump sampler2DArray; \n"
+			"\n"
+			"in vec3 v_textures; \n"
+			"out vec4 fragColor; \n"
+			"uniform sampler2DArray shapeMasks; \n"
+			"uniform float u_flat; \n"
+			+ ShapePaletteShader() +
+			"\n"
+			"void main() \n"
+			"{ \n"
+			" ivec2 layers = CellMaskLayers(v_textures.z); \n"
+			" float shape; \n"
+			" float frame; \n"
+			// The 1x1 mip levels hold the average masks, coloured they come close to the average colour of the cell
+			" if(u_flat > 0.0) \n"
+			" { \n"
+			"  float level = log2(float(textureSize(shapeMasks, 0).x)); \n"
+			"  shape = textureLod(shapeMasks, vec3(0.5, 0.5, layers.x), level).r; \n"
+			"  frame = textureLod(shapeMasks, vec3(0.5, 0.5, layers.y), level).r; \n"
+			" } \n"
+			" else \n"
+			" { \n"
+			"  shape = texture(shapeMasks, vec3(v_textures.xy, layers.x)).r; \n"
+			"  frame = texture(shapeMasks, vec3(v_textures.xy, layers.y)).r; \n"
+			" } \n"
+			" fragColor = ColourCell(shape, frame, v_textures.z); \n"
+			"} \n";
+	}
+
+	/// @brief Upload every shape & frame mask into one layer of a single channel texture array
+	/// @param assets loader of the masks
+	/// @return Texture array object
+	static GLuint LoadMaskTextureArray(AssetLoader& assets)
+	{
+		GLuint texture;
+		glGenTextures(1, &texture);
+		GetGLState().bindTexture(0, GL_TEXTURE_2D_ARRAY, texture);
+
+		// Set the texture wrapping/filtering options (on currently bound texture)
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		// Sampling reads the mip levels, so cells smaller than the masks and the flat LOD see the averaged masks
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		// Storage for the whole mip chain, down to 1x1
+		int levelCount = 1;
+		for(int size = shapeTextureSize; size > 1; size /= 2)
+		{
+			levelCount++;
+		}
+		for(int level = 0, size = shapeTextureSize; level < levelCount; level++, size /= 2)
+		{
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_R8, size, size, Shape::maskLayerCount,
+				0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+		}
+
+		// Masks are uploaded as soon as they are loaded, the palette colours them in the shaders
+		bool missingLevels = false;
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		for(int layer = 0; layer < Shape::maskLayerCount; layer++)
+		{
+			const TextureImage& image = assets.maskImage(layer);
+			if (image.levels.empty() || image.levels[0].width != shapeTextureSize || image.levels[0].height != shapeTextureSize)
+			{
+				printf("Mask of layer %d is missing or not %dx%d\n", layer, shapeTextureSize, shapeTextureSize);
+				continue;
+			}
+
+			// Baked textures bring their mip chain along, decoded images only have the full size level
+			for(int level = 0; level < (int)image.levels.size() && level < levelCount; level++)
+			{
+				const TextureLevel& pixels = image.levels[level];
+				glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, layer,
+					pixels.width, pixels.height, 1, GL_RED, GL_UNSIGNED_BYTE, pixels.pixels);
+			}
+			missingLevels = missingLevels || (int)image.levels.size() < levelCount;
+		}
+		if(missingLevels)
+		{
+			glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+		}
+
+		return texture;
+	}
+
+	BoardRenderer::BoardRenderer(ShaderManager& shaders, AssetLoader& assets)
+		: mCellWidth(0.0f)
+		, mCellHeight(0.0f)
+		, mViewport({ -1.0f, -1.0f, 1.0f, 1.0f })
+		, mVisibleCells({ 0.0f, 0.0f, (float)GameLogic::gameBoardSize, (float)GameLogic::gameBoardSize })
+		, mFlat(false)
+		, mLastUpdateTime(0.0f)
+		, mAnimationEnd(restingStartTime)
+	{
+		std::string vShaderStr = BoardVertexShader(GameLogic::gameBoardSize);
+		std::string fShaderStr = BoardFragmentShader();
+		mProgram = shaders.createProgram(vShaderStr.c_str(), fShaderStr.c_str());
+		mCellSizeLocation = glGetUniformLocation(mProgram, "u_cellSize");
+		mTimeLocation = glGetUniformLocation(mProgram, "u_time");
+		mViewportLocation = glGetUniformLocation(mProgram, "u_viewport");
+		mVisibleCellsLocation = glGetUniformLocation(mProgram, "u_visibleCells");
+		mFlatLocation = glGetUniformLocation(mProgram, "u_flat");
+		SetShapePaletteUniforms(mProgram, assets.palette());
+		GetGLState().useProgram(0);
+
+		// Instance data lives in a uniform buffer indexed by gl_InstanceID
+		GLuint blockIndex = glGetUniformBlockIndex(mProgram, "CellInstances");
+		glUniformBlockBinding(mProgram, blockIndex, 0);
+
+		glGenBuffers(1, &mInstanceUbo);
+		GetGLState().bindBuffer(GL_UNIFORM_BUFFER, mInstanceUbo);
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(mInstances), nullptr, GL_DYNAMIC_DRAW);
+		GetGLState().bindBuffer(GL_UNIFORM_BUFFER, 0);
+		// A negative layer never matches a real one, so the first update uploads every entry
+		mInstances.fill({ 0.0f, 0.0f, -1.0f, restingStartTime, 0.0f, 0.0f, 1.0f, 0.0f });
+		mMotionSerials.fill(0);
+
+		// Static unit quad, corners in 0..1 from the top left of the cell
+		GLfloat corners[] = 	{
+								 0.0f, 0.0f,		// Top left
+								 1.0f, 0.0f,		// Top right
+								 0.0f, 1.0f,		// Bottom left
+								 1.0f, 1.0f		// Bottom right
+								};
+		glGenVertexArrays(1, &mQuadVao);
+		GetGLState().bindVertexArray(mQuadVao);
+		glGenBuffers(1, &mQuadVbo);
+		GetGLState().bindBuffer(GL_ARRAY_BUFFER, mQuadVbo);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+		glVertexAttribPointer ( 0, 2, GL_FLOAT, GL_FALSE, 0, nullptr );
+		GetGLState().enableVertexAttribArray(0);
+		mQuadIbo = CreateQuadIndexBuffer(1);
+		GetGLState().bindVertexArray(0);
+		GetGLState().bindBuffer(GL_ARRAY_BUFFER, 0);
+
+		mTextureArray = LoadMaskTextureArray(assets);
+	}
+
+	BoardRenderer::~BoardRenderer()
+	{
+		GetGLState().deleteTextures(1, &mTextureArray);
+		GetGLState().deleteBuffers(1, &mInstanceUbo);
+		GetGLState().deleteBuffers(1, &mQuadIbo);
+		GetGLState().deleteBuffers(1, &mQuadVbo);
+		GetGLState().deleteVertexArrays(1, &mQuadVao);
+	}
+
+	/// @brief Refresh the instance buffer from the game board
+	/// @param snapshot game state to draw
+	/// @param layout placement of the board cells through the camera, moving them after a resize or pan uploads every entry
+	/// @param time frame time, new motions start animating from here
+	void BoardRenderer::update(const GameSnapshot& snapshot, const Layout& layout, float time)
+	{
+		mCellWidth = layout.tileWidth();
+		mCellHeight = layout.tileHeight();
+		mViewport = { layout.boardLeft(), layout.boardBottom(), layout.boardRight(), layout.boardTop() };
+		mVisibleCells = { (float)layout.firstVisibleColumn(), (float)layout.firstVisibleRow(),
+			(float)layout.visibleColumns(), (float)layout.visibleRows() };
+		mFlat = layout.flatTiles();
+		mChangedCells.clear();
+
+		GetGLState().bindBuffer(GL_UNIFORM_BUFFER, mInstanceUbo);
+		// Consecutive changed entries are uploaded together as one range
+		int rangeStart = -1;
+		for(int cell = 0; cell <= cellCount; cell++)
+		{
+			bool changed = false;
+			if(cell < cellCount)
+			{
+				int rows = cell / GameLogic::gameBoardSize;
+				int columns = cell % GameLogic::gameBoardSize;
+				CellInstance& cached = mInstances[cell];
+				CellInstance instance = cached;
+				instance.x = layout.cellX(columns);
+				instance.y = layout.cellY(rows);
+				instance.layer = (GLfloat)snapshot.GetTextureLayerAt(rows, columns);
+
+				const CellMotion& motion = snapshot.GetMotionAt(rows, columns);
+				bool firstUpdate = cached.layer < 0.0f;
+				if(motion.serial != mMotionSerials[cell] && !firstUpdate)
+				{
+					// Refills never start above the board, where they would cover the score
+					int fromRow = motion.fromI < 0 ? 0 : motion.fromI;
+					instance.startTime = time;
+					instance.fromX = layout.cellX(motion.fromJ);
+					instance.fromY = layout.cellY(fromRow);
+					instance.fromScale = motion.spawned ? 0.0f : 1.0f;
+					mAnimationEnd = std::max(mAnimationEnd, time + cellAnimationSeconds);
+				}
+				else if(instance.x != cached.x || instance.y != cached.y)
+				{
+					// Moved by a resize or the camera, the cell snaps to its new place
+					instance.startTime = restingStartTime;
+					instance.fromX = instance.x;
+					instance.fromY = instance.y;
+					instance.fromScale = 1.0f;
+				}
+				mMotionSerials[cell] = motion.serial;
+
+				changed = instance.x != cached.x || instance.y != cached.y || instance.layer != cached.layer
+					|| instance.startTime != cached.startTime;
+				// Cells still moving since the last frame change their pixels without a new instance entry
+				bool moving = cached.startTime + cellAnimationSeconds > mLastUpdateTime;
+				if(changed)
+				{
+					cached = instance;
+				}
+				if(changed || moving)
+				{
+					mChangedCells.push_back(cell);
+				}
+			}
+
+			if(changed && rangeStart < 0)
+			{
+				rangeStart = cell;
+			}
+			else if(!changed && rangeStart >= 0)
+			{
+				glBufferSubData(GL_UNIFORM_BUFFER, rangeStart * sizeof(CellInstance),
+					(cell - rangeStart) * sizeof(CellInstance), &mInstances[rangeStart]);
+				rangeStart = -1;
+			}
+		}
+		mLastUpdateTime = time;
+	}
+
+	/// @brief Get the area a cell covers from the start to the end of its animation
+	/// @param cell row * gameBoardSize + column
+	void BoardRenderer::cellBounds(int cell, float& leftX, float& topY, float& rightX, float& bottomY) const
+	{
+		const CellInstance& instance = mInstances[cell];
+		leftX = std::min(instance.x, instance.fromX);
+		topY = std::max(instance.y, instance.fromY);
+		rightX = std::max(instance.x, instance.fromX) + mCellWidth;
+		bottomY = std::min(instance.y, instance.fromY) - mCellHeight;
+	}
+
+	/// @brief Shift every start time back by offset, only while nothing is animating
+	/// @param offset seconds the clock origin moves forward by
+	void BoardRenderer::rebaseTime(float offset)
+	{
+		for(CellInstance& instance : mInstances)
+		{
+			instance.startTime = std::min(instance.startTime - offset, restingStartTime);
+		}
+		mLastUpdateTime -= offset;
+		mAnimationEnd = std::min(mAnimationEnd - offset, restingStartTime);
+
+		GetGLState().bindBuffer(GL_UNIFORM_BUFFER, mInstanceUbo);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(mInstances), mInstances.data());
+	}
+
+	/// @brief Record the board draw, culled to the cells inside the board area
+	/// @param commands command buffer of the current frame
+	/// @param time frame time, the only value that changes while cells animate
+	void BoardRenderer::record(RenderCommandBuffer& commands, float time)
+	{
+		// Moving cells may cross into the board area from outside the visible cells, nothing is culled until they rest
+		std::array<float, 4> visible = mVisibleCells;
+		if(animating(time))
+		{
+			visible = { 0.0f, 0.0f, (float)GameLogic::gameBoardSize, (float)GameLogic::gameBoardSize };
+		}
+
+		DrawCommand& command = commands.addDraw(RenderLayer::BOARD, 5);
+		command.program = mProgram;
+		command.textureTarget = GL_TEXTURE_2D_ARRAY;
+		command.texture = mTextureArray;
+		command.uniformBuffer = mInstanceUbo;
+		command.vertexArray = mQuadVao;
+		command.mode = GL_TRIANGLES;
+		command.count = 6;
+		command.instanceCount = (GLsizei)(visible[2] * visible[3]);
+		command.uniforms[0] = { mCellSizeLocation, 2, { mCellWidth, mCellHeight } };
+		command.uniforms[1] = { mTimeLocation, 1, { time } };
+		command.uniforms[2] = { mViewportLocation, 4, { mViewport[0], mViewport[1], mViewport[2], mViewport[3] } };
+		command.uniforms[3] = { mVisibleCellsLocation, 3, { visible[0], visible[1], visible[2] } };
+		command.uniforms[4] = { mFlatLocation, 1, { mFlat ? 1.0f : 0.0f } };
+	}
+}
\ No newline at end of file
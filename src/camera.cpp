@@ -0,0 +1,50 @@
+#include <camera.hpp>
+
+#include <algorithm>
+
+namespace opengles_workspace
+{
+	const float minZoom = 1.0f;
+	// Three cells across the viewport at the closest
+	const float minVisibleCells = 3.0f;
+
+	Camera2D::Camera2D(int columns, int rows)
+		: mColumns(columns)
+		, mRows(rows)
+	{
+		reset();
+	}
+
+	/// @brief Change the magnification, keeping the middle of the view in place where the board edges allow
+	/// @param factor above 1 zooms in, below 1 zooms out
+	void Camera2D::zoomBy(float factor)
+	{
+		float maxZoom = std::max(minZoom, std::max(mColumns, mRows) / minVisibleCells);
+		mView.zoom = std::min(std::max(mView.zoom * factor, minZoom), maxZoom);
+		clampCenter();
+	}
+
+	/// @brief Move the middle of the view
+	/// @param columns cells to the right, negative to the left
+	/// @param rows cells down, negative up
+	void Camera2D::pan(float columns, float rows)
+	{
+		mView.centerColumn += columns;
+		mView.centerRow += rows;
+		clampCenter();
+	}
+
+	void Camera2D::reset()
+	{
+		mView = { minZoom, mColumns * 0.5f, mRows * 0.5f };
+	}
+
+	/// @brief Keep the edges of the view on the board, the view spans size / zoom cells in each direction
+	void Camera2D::clampCenter()
+	{
+		float halfColumns = mColumns * 0.5f / mView.zoom;
+		float halfRows = mRows * 0.5f / mView.zoom;
+		mView.centerColumn = std::min(std::max(mView.centerColumn, halfColumns), mColumns - halfColumns);
+		mView.centerRow = std::min(std::max(mView.centerRow, halfRows), mRows - halfRows);
+	}
+}
@@ -0,0 +1,119 @@
+#include <damage_tracker.hpp>
+
+#include <algorithm>
+
+namespace opengles_workspace
+{
+	static DamageRect Union(const DamageRect& first, const DamageRect& second)
+	{
+		int left = std::min(first.x, second.x);
+		int bottom = std::min(first.y, second.y);
+		int right = std::max(first.x + first.width, second.x + second.width);
+		int top = std::max(first.y + first.height, second.y + second.height);
+		return { left, bottom, right - left, top - bottom };
+	}
+
+	static bool Contains(const DamageRect& outer, const DamageRect& inner)
+	{
+		return inner.x >= outer.x && inner.y >= outer.y
+			&& inner.x + inner.width <= outer.x + outer.width
+			&& inner.y + inner.height <= outer.y + outer.height;
+	}
+
+	/// @brief Add a rectangle to a region, dropping it if already covered and collapsing the region when it grows too fragmented
+	/// @param region region to extend
+	/// @param rect rectangle to add
+	/// @param maxRects maximum number of rectangles kept separately
+	static void AddToRegion(std::vector<DamageRect>& region, const DamageRect& rect, int maxRects)
+	{
+		for(const DamageRect& existing : region)
+		{
+			if(Contains(existing, rect))
+			{
+				return;
+			}
+		}
+		region.erase(std::remove_if(region.begin(), region.end(),
+			[&](const DamageRect& existing) { return Contains(rect, existing); }), region.end());
+		region.push_back(rect);
+
+		if((int)region.size() > maxRects)
+		{
+			DamageRect bounds = region.front();
+			for(const DamageRect& existing : region)
+			{
+				bounds = Union(bounds, existing);
+			}
+			region.assign(1, bounds);
+		}
+	}
+
+	DamageTracker::DamageTracker(int historyLength)
+		: mHistoryLength(historyLength)
+		, mWidth(0)
+		, mHeight(0)
+	{}
+
+	/// @brief Set the framebuffer size and damage the whole frame
+	/// @param width framebuffer width in pixels
+	/// @param height framebuffer height in pixels
+	void DamageTracker::resize(int width, int height)
+	{
+		mWidth = width;
+		mHeight = height;
+		// Older frames were a different size, none of them can be reused
+		mHistory.clear();
+		addFullFrame();
+	}
+
+	/// @brief Damage a rectangle of the current frame, clipped to the framebuffer
+	/// @param rect damaged rectangle
+	void DamageTracker::addRect(DamageRect rect)
+	{
+		int left = std::max(rect.x, 0);
+		int bottom = std::max(rect.y, 0);
+		int right = std::min(rect.x + rect.width, mWidth);
+		int top = std::min(rect.y + rect.height, mHeight);
+		if(right <= left || top <= bottom)
+		{
+			return;
+		}
+		AddToRegion(mFrameDamage, { left, bottom, right - left, top - bottom }, maxFrameRects);
+	}
+
+	void DamageTracker::addFullFrame()
+	{
+		mFrameDamage.assign(1, { 0, 0, mWidth, mHeight });
+	}
+
+	/// @brief Get the region to repaint for a back buffer of the given age
+	/// @param bufferAge frames since the back buffer was last presented, 0 if its contents are undefined
+	/// @return Current damage plus the damage of every frame the back buffer missed
+	std::vector<DamageRect> DamageTracker::repaintRegion(int bufferAge) const
+	{
+		if(bufferAge <= 0 || bufferAge - 1 > (int)mHistory.size())
+		{
+			return { { 0, 0, mWidth, mHeight } };
+		}
+
+		std::vector<DamageRect> region = mFrameDamage;
+		for(int frame = 0; frame < bufferAge - 1; frame++)
+		{
+			for(const DamageRect& rect : mHistory[frame])
+			{
+				AddToRegion(region, rect, maxFrameRects);
+			}
+		}
+		return region;
+	}
+
+	void DamageTracker::endFrame()
+	{
+		mHistory.push_front(std::move(mFrameDamage));
+		if((int)mHistory.size() > mHistoryLength)
+		{
+			mHistory.pop_back();
+		}
+		mFrameDamage.clear();
+	}
+}
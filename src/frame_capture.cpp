@@ -0,0 +1,44 @@
+#include <frame_capture.hpp>
+
+#include <cstring>
+
+#include <glad/gl.h>
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+
+namespace opengles_workspace
+{
+	/// @brief Synchronously read back the color buffer
+	/// @param width framebuffer width
+	/// @param height framebuffer height
+	/// @param pixels receives width * height RGBA pixels
+	void ReadFramebuffer(int width, int height, std::vector<unsigned char>& pixels)
+	{
+		pixels.resize((size_t)width * height * 4);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	}
+
+	/// @brief Save pixels as PNG, flipping them if needed so the top row comes first
+	/// @param path file to write
+	/// @param width image width
+	/// @param height image height
+	/// @param pixels RGBA pixels
+	/// @param bottomRowFirst true for rows read back from GL
+	/// @return true if the file was written
+	bool WritePng(const std::string& path, int width, int height, const std::vector<unsigned char>& pixels, bool bottomRowFirst)
+	{
+		size_t rowSize = (size_t)width * 4;
+		if(!bottomRowFirst)
+		{
+			return stbi_write_png(path.c_str(), width, height, 4, pixels.data(), (int)rowSize) != 0;
+		}
+		std::vector<unsigned char> flipped(pixels.size());
+		for(int row = 0; row < height; row++)
+		{
+			memcpy(&flipped[row * rowSize], &pixels[(height - 1 - row) * rowSize], rowSize);
+		}
+		return stbi_write_png(path.c_str(), width, height, 4, flipped.data(), (int)rowSize) != 0;
+	}
+}
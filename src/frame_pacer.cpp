@@ -0,0 +1,141 @@
+#include <frame_pacer.hpp>
+#include <exception.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+namespace opengles_workspace
+{
+	// Sleeping wakes up late by up to the scheduler tick, the last stretch before a deadline is spun instead
+	const std::chrono::microseconds spinMargin(2000);
+
+	/// @brief Parse a present mode name
+	/// @param name vsync, adaptive, uncapped or limited
+	/// @return Present mode, throws Exception for unknown names
+	PresentMode PresentOptions::ParseMode(const std::string& name)
+	{
+		if(name == "vsync")
+		{
+			return PresentMode::VSYNC;
+		}
+		if(name == "adaptive")
+		{
+			return PresentMode::ADAPTIVE;
+		}
+		if(name == "uncapped")
+		{
+			return PresentMode::UNCAPPED;
+		}
+		if(name == "limited")
+		{
+			return PresentMode::LIMITED;
+		}
+		throw Exception("Unknown present mode: " + name);
+	}
+
+	/// @brief Set the swap interval of the current context
+	/// @param mode present mode
+	void ApplyPresentMode(PresentMode mode)
+	{
+		switch(mode)
+		{
+		case PresentMode::VSYNC:
+			glfwSwapInterval(1);
+			break;
+		case PresentMode::ADAPTIVE:
+			// A negative interval only means late swap tearing with the tear control extension
+			if(glfwExtensionSupported("WGL_EXT_swap_control_tear") || glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+			{
+				glfwSwapInterval(-1);
+			}
+			else
+			{
+				fprintf(stderr, "Adaptive vsync is not supported, using vsync\n");
+				glfwSwapInterval(1);
+			}
+			break;
+		case PresentMode::UNCAPPED:
+		case PresentMode::LIMITED:
+			glfwSwapInterval(0);
+			break;
+		}
+	}
+
+	FramePacer::FramePacer(int framesPerSecond)
+		: mPeriod(std::chrono::nanoseconds(1000000000) / std::max(1, framesPerSecond))
+		, mNextFrame(std::chrono::steady_clock::now())
+	{
+	}
+
+	void FramePacer::wait()
+	{
+		FrameTime now = std::chrono::steady_clock::now();
+		if(now < mNextFrame)
+		{
+			if(mNextFrame - now > spinMargin)
+			{
+				std::this_thread::sleep_until(mNextFrame - spinMargin);
+			}
+			while(std::chrono::steady_clock::now() < mNextFrame)
+			{
+				std::this_thread::yield();
+			}
+			mNextFrame += mPeriod;
+		}
+		else
+		{
+			// Idle or late, pace from now instead of rushing to catch up on missed frames
+			mNextFrame = now + mPeriod;
+		}
+	}
+
+	PresentStats::PresentStats(double scanOutMs)
+		: mScanOutMs(scanOutMs)
+	{
+	}
+
+	/// @brief Record a present that just returned
+	/// @param input arrival time of the oldest input the frame shows, none for frames that only animate or capture
+	/// @param backToBack the frame was already waiting when the previous one was presented
+	void PresentStats::presented(std::optional<FrameTime> input, bool backToBack)
+	{
+		FrameTime now = std::chrono::steady_clock::now();
+		if(backToBack)
+		{
+			mIntervalsMs.push_back(std::chrono::duration<double, std::milli>(now - mLastPresent).count());
+		}
+		if(input)
+		{
+			mInputLatenciesMs.push_back(std::chrono::duration<double, std::milli>(now - *input).count() + mScanOutMs);
+		}
+		mLastPresent = now;
+	}
+
+	static void PrintDistribution(const char* name, std::vector<double> values)
+	{
+		if(values.empty())
+		{
+			printf("%s: no samples\n", name);
+			return;
+		}
+		std::sort(values.begin(), values.end());
+		double sum = 0.0;
+		for(double value : values)
+		{
+			sum += value;
+		}
+		auto percentile = [&values](double p) { return values[(size_t)(p * (values.size() - 1))]; };
+		printf("%s: %zu samples, mean %.2f ms, p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+			name, values.size(), sum / values.size(), percentile(0.5), percentile(0.95), percentile(0.99), values.back());
+	}
+
+	void PresentStats::print() const
+	{
+		PrintDistribution("Present interval", mIntervalsMs);
+		PrintDistribution("Input to photon (estimated)", mInputLatenciesMs);
+	}
+}
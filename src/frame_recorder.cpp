@@ -0,0 +1,316 @@
+#include <frame_recorder.hpp>
+#include <frame_capture.hpp>
+#include <gl_extensions.hpp>
+#include <gl_state_cache.hpp>
+#include <profiler.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+
+namespace opengles_workspace
+{
+	/// @brief Append one frame to a Y4M file as full range BT.601 4:2:0, the chroma of every 2x2 block averaged
+	/// @param file Y4M file with its header written
+	/// @param videoWidth even frame width of the file
+	/// @param videoHeight even frame height of the file
+	/// @param width width of the pixels, cropped or padded with black to the file size
+	/// @param height height of the pixels
+	/// @param pixels RGBA pixels, bottom row first
+	static void WriteY4mFrame(FILE* file, int videoWidth, int videoHeight, int width, int height, const std::vector<unsigned char>& pixels)
+	{
+		std::vector<unsigned char> luma((size_t)videoWidth * videoHeight);
+		std::vector<unsigned char> blue((size_t)videoWidth * videoHeight / 4);
+		std::vector<unsigned char> red(blue.size());
+		auto pixel = [&](int x, int y, int channel) -> float
+		{
+			if(x >= width || y >= height)
+			{
+				return 0.0f;
+			}
+			return pixels[((size_t)(height - 1 - y) * width + x) * 4 + channel];
+		};
+		for(int y = 0; y < videoHeight; y += 2)
+		{
+			for(int x = 0; x < videoWidth; x += 2)
+			{
+				float sumBlue = 0.0f;
+				float sumRed = 0.0f;
+				for(int corner = 0; corner < 4; corner++)
+				{
+					int cornerX = x + (corner & 1);
+					int cornerY = y + (corner >> 1);
+					float r = pixel(cornerX, cornerY, 0);
+					float g = pixel(cornerX, cornerY, 1);
+					float b = pixel(cornerX, cornerY, 2);
+					luma[(size_t)cornerY * videoWidth + cornerX] = (unsigned char)std::min(255.0f, 0.299f * r + 0.587f * g + 0.114f * b + 0.5f);
+					sumBlue += 128.0f - 0.168736f * r - 0.331264f * g + 0.5f * b;
+					sumRed += 128.0f + 0.5f * r - 0.418688f * g - 0.081312f * b;
+				}
+				size_t chroma = (size_t)(y / 2) * (videoWidth / 2) + x / 2;
+				blue[chroma] = (unsigned char)std::min(255.0f, std::max(0.0f, sumBlue * 0.25f + 0.5f));
+				red[chroma] = (unsigned char)std::min(255.0f, std::max(0.0f, sumRed * 0.25f + 0.5f));
+			}
+		}
+		fputs("FRAME\n", file);
+		fwrite(luma.data(), 1, luma.size(), file);
+		fwrite(blue.data(), 1, blue.size(), file);
+		fwrite(red.data(), 1, red.size(), file);
+	}
+
+	FrameRecorder::FrameRecorder(std::string directory, int framesPerSecond)
+		: mDirectory(std::move(directory))
+		, mFramesPerSecond(framesPerSecond)
+		, mFileCount(0)
+		, mScreenshotRequested(false)
+		, mRecording(false)
+		, mNextBuffer(0)
+		, mStopping(false)
+	{
+		for(ReadBuffer& buffer : mBuffers)
+		{
+			glGenBuffers(1, &buffer.buffer);
+			buffer.capacity = 0;
+			buffer.fence = nullptr;
+			buffer.width = 0;
+			buffer.height = 0;
+			buffer.age = 0;
+		}
+		mEncoder = std::thread(&FrameRecorder::encode, this);
+	}
+
+	FrameRecorder::~FrameRecorder()
+	{
+		collect(true);
+		if(mRecording)
+		{
+			push({ 0, 0, {}, "", "", true });
+		}
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mStopping = true;
+		}
+		mCondition.notify_one();
+		mEncoder.join();
+
+		for(ReadBuffer& buffer : mBuffers)
+		{
+			GetGLState().deleteBuffers(1, &buffer.buffer);
+		}
+	}
+
+	void FrameRecorder::requestScreenshot()
+	{
+		mScreenshotRequested = true;
+	}
+
+	/// @brief Start recording into a new file, or finish the current one once the frames in flight are encoded
+	void FrameRecorder::toggleRecording()
+	{
+		if(!mRecording)
+		{
+			mVideoPath = nextPath("recording", "y4m");
+			mRecording = true;
+			printf("Recording to %s\n", mVideoPath.c_str());
+			return;
+		}
+		collect(true);
+		push({ 0, 0, {}, "", "", true });
+		mRecording = false;
+		printf("Recording stopped\n");
+	}
+
+	/// @brief Queue a read of the back buffer into the next pixel buffer, returns before the GPU gets to it
+	/// @param width framebuffer width
+	/// @param height framebuffer height
+	void FrameRecorder::readFrame(int width, int height)
+	{
+		if(!wantsFrame())
+		{
+			return;
+		}
+		PROFILE_ZONE("capture read");
+		// The ring came around, the oldest read has to make room
+		if((int)mInFlight.size() == bufferCount)
+		{
+			mapOldest();
+		}
+
+		ReadBuffer& buffer = mBuffers[mNextBuffer];
+		buffer.width = width;
+		buffer.height = height;
+		buffer.screenshotPath = mScreenshotRequested ? nextPath("screenshot", "png") : "";
+		buffer.videoPath = mRecording ? mVideoPath : "";
+		buffer.age = 0;
+		mScreenshotRequested = false;
+
+		GLStateCache& state = GetGLState();
+		state.bindBuffer(GL_PIXEL_PACK_BUFFER, buffer.buffer);
+		size_t size = (size_t)width * height * 4;
+		if(size > buffer.capacity)
+		{
+			glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+			buffer.capacity = size;
+		}
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		// With a pack buffer bound the pointer is an offset into it
+		glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		// Client memory reads elsewhere must not land in the buffer
+		state.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		const GLExtensions& extensions = GetGLExtensions();
+		if(extensions.sync)
+		{
+			buffer.fence = extensions.FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		}
+		for(int index : mInFlight)
+		{
+			mBuffers[index].age++;
+		}
+		mInFlight.push_back(mNextBuffer);
+		mNextBuffer = (mNextBuffer + 1) % bufferCount;
+	}
+
+	/// @brief Map the reads the GPU finished, in the order they were made
+	/// @param wait also map the reads still running, e.g. when no further frame comes to push them out
+	void FrameRecorder::collect(bool wait)
+	{
+		const GLExtensions& extensions = GetGLExtensions();
+		while(!mInFlight.empty())
+		{
+			ReadBuffer& buffer = mBuffers[mInFlight.front()];
+			if(!wait)
+			{
+				bool done = extensions.sync
+					? extensions.ClientWaitSync(buffer.fence, 0, 0) != GL_TIMEOUT_EXPIRED
+					: buffer.age >= bufferCount - 1;
+				if(!done)
+				{
+					return;
+				}
+			}
+			mapOldest();
+		}
+	}
+
+	std::string FrameRecorder::nextPath(const char* prefix, const char* extension)
+	{
+		char stamp[32];
+		std::time_t now = std::time(nullptr);
+		std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", std::localtime(&now));
+		// Files of the same second are told apart by the count
+		return mDirectory + "/" + prefix + "_" + stamp + "_" + std::to_string(mFileCount++) + "." + extension;
+	}
+
+	/// @brief Copy the oldest read out of its buffer & hand it to the encoder, waits if the GPU is not done yet
+	void FrameRecorder::mapOldest()
+	{
+		PROFILE_ZONE("capture map");
+		ReadBuffer& buffer = mBuffers[mInFlight.front()];
+		mInFlight.pop_front();
+
+		const GLExtensions& extensions = GetGLExtensions();
+		if(buffer.fence)
+		{
+			extensions.DeleteSync(buffer.fence);
+			buffer.fence = nullptr;
+		}
+
+		EncodeJob job = { buffer.width, buffer.height, {}, buffer.screenshotPath, buffer.videoPath, false };
+		size_t size = (size_t)buffer.width * buffer.height * 4;
+		GLStateCache& state = GetGLState();
+		state.bindBuffer(GL_PIXEL_PACK_BUFFER, buffer.buffer);
+		const unsigned char* pixels = (const unsigned char*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+		if(pixels)
+		{
+			job.pixels.assign(pixels, pixels + size);
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		}
+		state.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		if(!pixels)
+		{
+			fprintf(stderr, "Failed to map a captured frame\n");
+			return;
+		}
+		push(std::move(job));
+	}
+
+	void FrameRecorder::push(EncodeJob job)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mJobs.push_back(std::move(job));
+		}
+		mCondition.notify_one();
+	}
+
+	/// @brief Encoder thread, writes queued frames until the recorder is destroyed & the queue is empty
+	void FrameRecorder::encode()
+	{
+		Profiler::SetThreadName("capture encoder");
+		FILE* video = nullptr;
+		std::string videoPath;
+		int videoWidth = 0;
+		int videoHeight = 0;
+		while(true)
+		{
+			EncodeJob job;
+			{
+				std::unique_lock<std::mutex> lock(mMutex);
+				mCondition.wait(lock, [this] { return mStopping || !mJobs.empty(); });
+				if(mJobs.empty())
+				{
+					break;
+				}
+				job = std::move(mJobs.front());
+				mJobs.pop_front();
+			}
+
+			PROFILE_ZONE("capture encode");
+			if(!job.screenshotPath.empty())
+			{
+				if(WritePng(job.screenshotPath, job.width, job.height, job.pixels))
+				{
+					printf("Screenshot written to %s\n", job.screenshotPath.c_str());
+				}
+				else
+				{
+					fprintf(stderr, "Failed to write screenshot to %s\n", job.screenshotPath.c_str());
+				}
+			}
+			if(job.endVideo || job.videoPath != videoPath)
+			{
+				if(video)
+				{
+					fclose(video);
+					video = nullptr;
+				}
+				videoPath.clear();
+			}
+			if(!job.videoPath.empty() && job.videoPath != videoPath)
+			{
+				// 4:2:0 needs even sizes, the size of the first frame holds for the whole file
+				videoPath = job.videoPath;
+				videoWidth = job.width & ~1;
+				videoHeight = job.height & ~1;
+				video = fopen(videoPath.c_str(), "wb");
+				if(video)
+				{
+					fprintf(video, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", videoWidth, videoHeight, mFramesPerSecond);
+				}
+				else
+				{
+					fprintf(stderr, "Failed to open %s for recording\n", videoPath.c_str());
+				}
+			}
+			if(video)
+			{
+				WriteY4mFrame(video, videoWidth, videoHeight, job.width, job.height, job.pixels);
+			}
+		}
+		if(video)
+		{
+			fclose(video);
+		}
+	}
+}
@@ -1,4 +1,5 @@
 #include <game_logic.hpp>
+#include <profiler.hpp>
 #include <stdio.h>
 
 namespace opengles_workspace
@@ -9,6 +10,8 @@ namespace opengles_workspace
     int GameLogic::currentJ = 0;
     int GameLogic::score = 0;
     bool GameLogic::isSomethingSelected = false;
+    CellMotion GameLogic::cellMotions[gameBoardSize][gameBoardSize] = {};
+    unsigned int GameLogic::motionSerial = 0;
 
     #define currentShape    shapeMatrix[currentI][currentJ]
     #define shapeUp         shapeMatrix[currentI - 1][currentJ]
@@ -64,6 +67,45 @@ namespace opengles_workspace
         return isSomethingSelected;
     }
 
+    /// @brief Copy the current game state
+    /// @return Snapshot with the texture layer of every shape, cursor & score
+    GameSnapshot GameLogic::GetSnapshot()
+    {
+        GameSnapshot snapshot;
+        for (int i = 0; i < gameBoardSize; i++)
+        {
+            for (int j = 0; j < gameBoardSize; j++)
+            {
+                snapshot.textureLayers[i * gameBoardSize + j] = shapeMatrix[i][j].GetTextureLayer();
+                snapshot.motions[i * gameBoardSize + j] = cellMotions[i][j];
+            }
+        }
+        snapshot.currentI = currentI;
+        snapshot.currentJ = currentJ;
+        snapshot.score = score;
+        return snapshot;
+    }
+
+    /// @brief Remember that the shapes of two cells traded places
+    /// @param firstI first cell index i
+    /// @param firstJ first cell index j
+    /// @param secondI second cell index i
+    /// @param secondJ second cell index j
+    void GameLogic::RecordSwap(int firstI, int firstJ, int secondI, int secondJ)
+    {
+        cellMotions[firstI][firstJ] = { ++motionSerial, secondI, secondJ, false };
+        cellMotions[secondI][secondJ] = { ++motionSerial, firstI, firstJ, false };
+    }
+
+    /// @brief Remember that a cell got a new shape dropping in from above
+    /// @param I cell index i
+    /// @param J cell index j
+    /// @param fromI row the new shape falls from, negative above the board
+    void GameLogic::RecordSpawn(int I, int J, int fromI)
+    {
+        cellMotions[I][J] = { ++motionSerial, fromI, J, true };
+    }
+
     /// @brief Check a shift made between two shapes
     /// @param firstShape first shape to check
     /// @param secondShape second shape to check
@@ -222,6 +264,8 @@ namespace opengles_workspace
     void GameLogic::RandomizeCorrectShapes(int I, int J, int sameShapesCountDir1, int sameShapesCountDir2, Axis axis)
     {
         //shapeMatrix[I][J].SetShapeColour(NONE);
+        // The refill of a vertical match falls in from the rows above it, a horizontal one from one row up
+        int runLength = sameShapesCountDir1 + sameShapesCountDir2 + 1;
         switch (axis)
         {
         case VERTICAL:
@@ -230,12 +274,14 @@ namespace opengles_workspace
             {
                 //shapeMatrix[I-i][J].SetColour(BASE);
                 shapeMatrix[I-i][J].SetRandomColour();
+                RecordSpawn(I-i, J, I-i-runLength);
             }
             // DOWN
             for(int i = 0; i <= sameShapesCountDir2; i++)
             {
                 //shapeMatrix[I+i][J].SetColour(BASE);
                 shapeMatrix[I+i][J].SetRandomColour();
+                RecordSpawn(I+i, J, I+i-runLength);
             }
             
             break;
@@ -245,12 +291,14 @@ namespace opengles_workspace
             {
                 //shapeMatrix[I][J-j].SetColour(BASE);
                 shapeMatrix[I][J-j].SetRandomColour();
+                RecordSpawn(I, J-j, I-1);
             }
             // RIGHT
             for(int j = 0; j <= sameShapesCountDir2; j++)
             {
                 //shapeMatrix[I][J+j].SetColour(BASE);
                 shapeMatrix[I][J+j].SetRandomColour();
+                RecordSpawn(I, J+j, I-1);
             }
             break;
         default:
@@ -262,6 +310,7 @@ namespace opengles_workspace
     /// @param direction movement direction (UP, LEFT, DOWN, RIGHT)
     void GameLogic::Move(Direction direction)
     {
+        PROFILE_ZONE("GameLogic::Move");
         ShapeColour currentShapeColour = currentShape.GetColour();
         switch (direction)
         {
@@ -273,6 +322,7 @@ namespace opengles_workspace
                 {
                     currentShape.SetColour(shapeUp.GetColour());
                     shapeUp.SetColour(currentShapeColour);
+                    RecordSwap(currentI, currentJ, currentI - 1, currentJ);
                     printf("Shifted UP --- %s[%d][%d] -> %s[%d][%d]\n",
                                                                        shapeUp.GetColourAsString(), currentI, currentJ,
                                                                        currentShape.GetColourAsString(), currentI - 1, currentJ);
@@ -301,6 +351,7 @@ namespace opengles_workspace
                 {
                     currentShape.SetColour(shapeLeft.GetColour());
                     shapeLeft.SetColour(currentShapeColour);
+                    RecordSwap(currentI, currentJ, currentI, currentJ - 1);
                     printf("Shifted LEFT --- %s[%d][%d] -> %s[%d][%d]\n",
                                                                          shapeLeft.GetColourAsString(), currentI, currentJ,
                                                                          currentShape.GetColourAsString(), currentI, currentJ - 1);
@@ -329,6 +380,7 @@ namespace opengles_workspace
                 {
                     currentShape.SetColour(shapeDown.GetColour());
                     shapeDown.SetColour(currentShapeColour);
+                    RecordSwap(currentI, currentJ, currentI + 1, currentJ);
                     printf("Shifted DOWN --- %s[%d][%d] -> %s[%d][%d]\n",
                                                                          shapeDown.GetColourAsString(), currentI, currentJ,
                                                                          currentShape.GetColourAsString(), currentI + 1, currentJ);
@@ -357,6 +409,7 @@ namespace opengles_workspace
                 {
                     currentShape.SetColour(shapeRight.GetColour());
                     shapeRight.SetColour(currentShapeColour);
+                    RecordSwap(currentI, currentJ, currentI, currentJ + 1);
                     printf("Shifted RIGHT --- %s[%d][%d] -> %s[%d][%d]\n",
                                                                           shapeRight.GetColourAsString(), currentI, currentJ,
                                                                           currentShape.GetColourAsString(), currentI, currentJ + 1);
@@ -387,6 +440,7 @@ namespace opengles_workspace
     /// @brief Set current shape status as SELECTED (SELECTABLE if already SELECTED)
     void GameLogic::SelectShape()
     {
+        PROFILE_ZONE("GameLogic::SelectShape");
         if (currentShape.GetStatus() != SELECTED)
         {
             currentShape.SetStatus(SELECTED);
@@ -401,4 +455,28 @@ namespace opengles_workspace
         }
     }
 
+    /// @brief Apply the deterministic input of one frame, for headless runs & benchmarks
+    /// @param frame frame number, the cursor snakes across the board and every seventh frame toggles a selection
+    void GameLogic::PlayScriptedFrame(int frame)
+    {
+        if (frame % 7 == 0)
+        {
+            SelectShape();
+            return;
+        }
+        int last = gameBoardSize - 1;
+        bool rightwards = currentI % 2 == 0;
+        if (rightwards ? currentJ < last : currentJ > 0)
+        {
+            Move(rightwards ? RIGHT : LEFT);
+        }
+        else if (currentI < last)
+        {
+            Move(DOWN);
+        }
+        else
+        {
+            Move(UP);
+        }
+    }
 }
\ No newline at end of file
@@ -0,0 +1,28 @@
+#include <geometry.hpp>
+
+namespace opengles_workspace
+{
+	/// @brief Create an element buffer with two triangles for every quad (top left, top right, bottom left, bottom right)
+	/// @param quadCount number of quads the buffer covers
+	/// @return Element buffer object
+	GLuint CreateQuadIndexBuffer(int quadCount)
+	{
+		std::vector<GLushort> indices;
+		indices.reserve(quadCount * 6);
+		for(int quad = 0; quad < quadCount; quad++)
+		{
+			GLushort first = (GLushort)(quad * 4);
+			GLushort quadIndices[] = { 0, 2, 1, 1, 2, 3 };
+			for(GLushort index : quadIndices)
+			{
+				indices.push_back(first + index);
+			}
+		}
+
+		GLuint ibo;
+		glGenBuffers(1, &ibo);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), indices.data(), GL_STATIC_DRAW);
+		return ibo;
+	}
+}
@@ -0,0 +1,97 @@
+#include <gl_extensions.hpp>
+
+#include <climits>
+#include <cstring>
+
+namespace opengles_workspace
+{
+	static GLExtensions extensions;
+
+	/// @brief Resolve the entry points missing from the generated loader
+	/// @param load loader of the current context, e.g. glfwGetProcAddress
+	void LoadGLExtensions(GLADloadfunc load)
+	{
+		extensions = GLExtensions();
+
+		// Loaders may hand out pointers for functions the driver does not implement, so check support first
+		if(HasGLVersion(4, 1, 3, 0) || HasGLExtension("GL_ARB_get_program_binary") || HasGLExtension("GL_OES_get_program_binary"))
+		{
+			extensions.GetProgramBinary = (PFNGETPROGRAMBINARYPROC)load("glGetProgramBinary");
+			extensions.ProgramBinary = (PFNPROGRAMBINARYPROC)load("glProgramBinary");
+			extensions.ProgramParameteri = (PFNPROGRAMPARAMETERIPROC)load("glProgramParameteri");
+			extensions.programBinary = extensions.GetProgramBinary && extensions.ProgramBinary && extensions.ProgramParameteri;
+		}
+
+		// GLES has no core timer queries, only the EXT entry points
+		if(HasGLVersion(3, 3, INT_MAX, 0) || HasGLExtension("GL_ARB_timer_query"))
+		{
+			extensions.QueryCounter = (PFNQUERYCOUNTERPROC)load("glQueryCounter");
+			extensions.GetQueryObjectui64v = (PFNGETQUERYOBJECTUI64VPROC)load("glGetQueryObjectui64v");
+			extensions.GetInteger64v = (PFNGETINTEGER64VPROC)load("glGetInteger64v");
+		}
+		else if(HasGLExtension("GL_EXT_disjoint_timer_query"))
+		{
+			extensions.QueryCounter = (PFNQUERYCOUNTERPROC)load("glQueryCounterEXT");
+			extensions.GetQueryObjectui64v = (PFNGETQUERYOBJECTUI64VPROC)load("glGetQueryObjectui64vEXT");
+			extensions.GetInteger64v = (PFNGETINTEGER64VPROC)load("glGetInteger64vEXT");
+			extensions.timerQueryDisjoint = true;
+		}
+		extensions.timerQuery = extensions.QueryCounter && extensions.GetQueryObjectui64v && extensions.GetInteger64v;
+
+		if(HasGLVersion(3, 2, 3, 0) || HasGLExtension("GL_ARB_sync"))
+		{
+			extensions.FenceSync = (PFNFENCESYNCPROC)load("glFenceSync");
+			extensions.ClientWaitSync = (PFNCLIENTWAITSYNCPROC)load("glClientWaitSync");
+			extensions.DeleteSync = (PFNDELETESYNCPROC)load("glDeleteSync");
+		}
+		extensions.sync = extensions.FenceSync && extensions.ClientWaitSync && extensions.DeleteSync;
+	}
+
+	/// @brief Get the entry points resolved by LoadGLExtensions
+	/// @return Resolved entry points, all unsupported before LoadGLExtensions ran
+	const GLExtensions& GetGLExtensions()
+	{
+		return extensions;
+	}
+
+	/// @brief Check the version of the current context
+	/// @param desktopMajor minimum desktop GL major version
+	/// @param desktopMinor minimum desktop GL minor version
+	/// @param esMajor minimum GLES major version
+	/// @param esMinor minimum GLES minor version
+	/// @return true if the context reaches the minimum of its API
+	bool HasGLVersion(int desktopMajor, int desktopMinor, int esMajor, int esMinor)
+	{
+		const char* version = (const char*)glGetString(GL_VERSION);
+		if(!version)
+		{
+			return false;
+		}
+		GLint major = 0, minor = 0;
+		glGetIntegerv(GL_MAJOR_VERSION, &major);
+		glGetIntegerv(GL_MINOR_VERSION, &minor);
+
+		bool es = strncmp(version, "OpenGL ES", 9) == 0;
+		int requiredMajor = es ? esMajor : desktopMajor;
+		int requiredMinor = es ? esMinor : desktopMinor;
+		return major > requiredMajor || (major == requiredMajor && minor >= requiredMinor);
+	}
+
+	/// @brief Check whether the current context advertises an extension
+	/// @param name extension name
+	/// @return true if the extension is listed
+	bool HasGLExtension(const char* name)
+	{
+		GLint count = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+		for(GLint index = 0; index < count; index++)
+		{
+			const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, index);
+			if(extension && strcmp(extension, name) == 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+}
\ No newline at end of file
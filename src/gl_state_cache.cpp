@@ -0,0 +1,390 @@
+#include <gl_state_cache.hpp>
+
+#include <algorithm>
+
+namespace opengles_workspace
+{
+	// Never handed out by glGen*, so the first call after invalidate() always reaches the driver
+	const GLuint unknownName = 0xFFFFFFFF;
+	const int unknownEnabled = -1;
+
+	/// @brief Slot of a texture target in the per unit bindings
+	/// @return -1 for targets that are not cached
+	static int TextureTargetIndex(GLenum target)
+	{
+		switch(target)
+		{
+		case GL_TEXTURE_2D:
+			return 0;
+		case GL_TEXTURE_2D_ARRAY:
+			return 1;
+		case GL_TEXTURE_3D:
+			return 2;
+		default:
+			return -1;
+		}
+	}
+
+	/// @brief Slot of a generic buffer binding
+	/// @return -1 for targets that are not cached
+	static int BufferTargetIndex(GLenum target)
+	{
+		switch(target)
+		{
+		case GL_ARRAY_BUFFER:
+			return 0;
+		case GL_UNIFORM_BUFFER:
+			return 1;
+		case GL_PIXEL_PACK_BUFFER:
+			return 2;
+		case GL_PIXEL_UNPACK_BUFFER:
+			return 3;
+		default:
+			return -1;
+		}
+	}
+
+	GLStateCache::GLStateCache()
+	{
+		invalidate();
+	}
+
+	void GLStateCache::invalidate()
+	{
+		mProgram = unknownName;
+		mActiveUnit = unknownName;
+		for(std::array<GLuint, textureTargetCount>& unit : mTextures)
+		{
+			unit.fill(unknownName);
+		}
+		mBuffers.fill(unknownName);
+		mUniformBindings.fill(unknownName);
+		mVertexArray = unknownName;
+		mFramebuffer = unknownName;
+		mEnabledAttributes.clear();
+		mUniforms.clear();
+		mBlend = unknownEnabled;
+		mScissorTest = unknownEnabled;
+		mBlendFunc.fill(unknownName);
+		// Negative sizes are invalid, so no real rectangle matches
+		mScissor.fill(-1);
+		mViewport.fill(-1);
+	}
+
+	bool GLStateCache::unchanged(bool same)
+	{
+		if(same)
+		{
+			mCounters.skipped++;
+		}
+		else
+		{
+			mCounters.issued++;
+		}
+		return same;
+	}
+
+	void GLStateCache::useProgram(GLuint program)
+	{
+		if(unchanged(program == mProgram))
+		{
+			return;
+		}
+		mProgram = program;
+		glUseProgram(program);
+	}
+
+	/// @brief Set a float uniform of the current program, skipped if the program already holds the values
+	/// @param location uniform location in the current program
+	/// @param components vector size, 1 to 4
+	/// @param values components values
+	void GLStateCache::uniform(GLint location, GLint components, const GLfloat* values)
+	{
+		std::array<GLfloat, 4> value = { 0.0f, 0.0f, 0.0f, 0.0f };
+		std::copy(values, values + components, value.begin());
+		// Uniforms belong to the program, they survive switching to another one
+		bool known = mProgram != unknownName && location >= 0;
+		if(known)
+		{
+			uint64_t key = ((uint64_t)mProgram << 32) | (uint32_t)location;
+			auto stored = mUniforms.find(key);
+			if(unchanged(stored != mUniforms.end() && stored->second == value))
+			{
+				return;
+			}
+			mUniforms[key] = value;
+		}
+		else
+		{
+			mCounters.issued++;
+		}
+		switch(components)
+		{
+		case 1:
+			glUniform1fv(location, 1, values);
+			break;
+		case 2:
+			glUniform2fv(location, 1, values);
+			break;
+		case 3:
+			glUniform3fv(location, 1, values);
+			break;
+		default:
+			glUniform4fv(location, 1, values);
+			break;
+		}
+	}
+
+	/// @brief Bind a texture to a unit
+	/// @param unit texture unit, 0 for GL_TEXTURE0
+	/// @param target texture target
+	/// @param texture texture name, 0 to unbind
+	void GLStateCache::bindTexture(GLuint unit, GLenum target, GLuint texture)
+	{
+		int targetIndex = TextureTargetIndex(target);
+		bool cached = targetIndex >= 0 && unit < (GLuint)textureUnitCount;
+		if(cached && unchanged(mTextures[unit][targetIndex] == texture))
+		{
+			return;
+		}
+		if(!unchanged(unit == mActiveUnit))
+		{
+			mActiveUnit = unit;
+			glActiveTexture(GL_TEXTURE0 + unit);
+		}
+		if(cached)
+		{
+			mTextures[unit][targetIndex] = texture;
+		}
+		else
+		{
+			mCounters.issued++;
+		}
+		glBindTexture(target, texture);
+	}
+
+	void GLStateCache::bindBuffer(GLenum target, GLuint buffer)
+	{
+		int targetIndex = BufferTargetIndex(target);
+		if(targetIndex < 0)
+		{
+			mCounters.issued++;
+		}
+		else if(unchanged(mBuffers[targetIndex] == buffer))
+		{
+			return;
+		}
+		else
+		{
+			mBuffers[targetIndex] = buffer;
+		}
+		glBindBuffer(target, buffer);
+	}
+
+	/// @brief Bind a buffer to an indexed binding point & the generic binding of its target
+	/// @param target GL_UNIFORM_BUFFER, other targets are not cached
+	/// @param index binding point
+	/// @param buffer buffer name
+	void GLStateCache::bindBufferBase(GLenum target, GLuint index, GLuint buffer)
+	{
+		bool cached = target == GL_UNIFORM_BUFFER && index < (GLuint)uniformBindingCount;
+		if(cached && unchanged(mUniformBindings[index] == buffer && mBuffers[BufferTargetIndex(target)] == buffer))
+		{
+			return;
+		}
+		if(cached)
+		{
+			mUniformBindings[index] = buffer;
+		}
+		else
+		{
+			mCounters.issued++;
+		}
+		int targetIndex = BufferTargetIndex(target);
+		if(targetIndex >= 0)
+		{
+			mBuffers[targetIndex] = buffer;
+		}
+		glBindBufferBase(target, index, buffer);
+	}
+
+	void GLStateCache::bindVertexArray(GLuint vertexArray)
+	{
+		if(unchanged(vertexArray == mVertexArray))
+		{
+			return;
+		}
+		mVertexArray = vertexArray;
+		glBindVertexArray(vertexArray);
+	}
+
+	void GLStateCache::bindFramebuffer(GLuint framebuffer)
+	{
+		if(unchanged(framebuffer == mFramebuffer))
+		{
+			return;
+		}
+		mFramebuffer = framebuffer;
+		glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	}
+
+	/// @brief Enable an attribute of the bound vertex array
+	/// @param index attribute location, below 32
+	void GLStateCache::enableVertexAttribArray(GLuint index)
+	{
+		if(mVertexArray == unknownName || index >= 32)
+		{
+			mCounters.issued++;
+		}
+		else
+		{
+			uint32_t& enabled = mEnabledAttributes[mVertexArray];
+			if(unchanged((enabled & (1u << index)) != 0))
+			{
+				return;
+			}
+			enabled |= 1u << index;
+		}
+		glEnableVertexAttribArray(index);
+	}
+
+	/// @brief glEnable or glDisable a capability
+	/// @param capability GL_BLEND & GL_SCISSOR_TEST are cached
+	/// @param enabled true to enable
+	void GLStateCache::setEnabled(GLenum capability, bool enabled)
+	{
+		int* state = capability == GL_BLEND ? &mBlend : capability == GL_SCISSOR_TEST ? &mScissorTest : nullptr;
+		if(!state)
+		{
+			mCounters.issued++;
+		}
+		else if(unchanged(*state == (int)enabled))
+		{
+			return;
+		}
+		else
+		{
+			*state = enabled;
+		}
+		if(enabled)
+		{
+			glEnable(capability);
+		}
+		else
+		{
+			glDisable(capability);
+		}
+	}
+
+	void GLStateCache::blendFunc(GLenum source, GLenum destination)
+	{
+		if(unchanged(mBlendFunc[0] == source && mBlendFunc[1] == destination))
+		{
+			return;
+		}
+		mBlendFunc = { source, destination };
+		glBlendFunc(source, destination);
+	}
+
+	void GLStateCache::scissor(GLint x, GLint y, GLsizei width, GLsizei height)
+	{
+		std::array<GLint, 4> rect = { x, y, width, height };
+		if(unchanged(rect == mScissor))
+		{
+			return;
+		}
+		mScissor = rect;
+		glScissor(x, y, width, height);
+	}
+
+	void GLStateCache::viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+	{
+		std::array<GLint, 4> rect = { x, y, width, height };
+		if(unchanged(rect == mViewport))
+		{
+			return;
+		}
+		mViewport = rect;
+		glViewport(x, y, width, height);
+	}
+
+	void GLStateCache::deleteProgram(GLuint program)
+	{
+		mCounters.issued++;
+		glDeleteProgram(program);
+		if(program == mProgram)
+		{
+			// The program stays in use until another replaces it, the name however may be reused
+			mProgram = unknownName;
+		}
+		for(auto uniform = mUniforms.begin(); uniform != mUniforms.end();)
+		{
+			if((GLuint)(uniform->first >> 32) == program)
+			{
+				uniform = mUniforms.erase(uniform);
+			}
+			else
+			{
+				++uniform;
+			}
+		}
+	}
+
+	void GLStateCache::deleteTextures(GLsizei count, const GLuint* textures)
+	{
+		mCounters.issued++;
+		glDeleteTextures(count, textures);
+		for(GLsizei index = 0; index < count; index++)
+		{
+			for(std::array<GLuint, textureTargetCount>& unit : mTextures)
+			{
+				std::replace(unit.begin(), unit.end(), textures[index], 0u);
+			}
+		}
+	}
+
+	void GLStateCache::deleteBuffers(GLsizei count, const GLuint* buffers)
+	{
+		mCounters.issued++;
+		glDeleteBuffers(count, buffers);
+		for(GLsizei index = 0; index < count; index++)
+		{
+			std::replace(mBuffers.begin(), mBuffers.end(), buffers[index], 0u);
+			std::replace(mUniformBindings.begin(), mUniformBindings.end(), buffers[index], 0u);
+		}
+	}
+
+	void GLStateCache::deleteVertexArrays(GLsizei count, const GLuint* vertexArrays)
+	{
+		mCounters.issued++;
+		glDeleteVertexArrays(count, vertexArrays);
+		for(GLsizei index = 0; index < count; index++)
+		{
+			if(vertexArrays[index] == mVertexArray)
+			{
+				mVertexArray = 0;
+			}
+			mEnabledAttributes.erase(vertexArrays[index]);
+		}
+	}
+
+	void GLStateCache::deleteFramebuffers(GLsizei count, const GLuint* framebuffers)
+	{
+		mCounters.issued++;
+		glDeleteFramebuffers(count, framebuffers);
+		for(GLsizei index = 0; index < count; index++)
+		{
+			if(framebuffers[index] == mFramebuffer)
+			{
+				mFramebuffer = 0;
+			}
+		}
+	}
+
+	GLStateCache& GetGLState()
+	{
+		// One context per thread, the render thread & the main thread each have their own
+		static thread_local GLStateCache cache;
+		return cache;
+	}
+}
@@ -1,120 +1,205 @@
-#include "glfw_application.hpp"
-#include "exception.hpp"
-#include "context.hpp"
-#include "input.hpp"
-#include "main_loop.hpp"
-#include "renderer.hpp"
-
-#include <memory>
-#include <iostream>
-#include <cassert>
-
-#define GLFW_WINDOW(ptr) reinterpret_cast<GLFWwindow*>(ptr)
-
-namespace opengles_workspace
-{
-typedef void(*GLFWwindowDeleter)(GLFWwindow*);
-
-void error_callback(int error, const char* description) {
-	fprintf(stderr, "GLFW error: %s\n", description);
-}
-
-void destroyGlfwWindow(GLFWwindow* window) {
-	glfwDestroyWindow(window);
-}
-
-GlfwApplication::GlfwApplication(size_t width, size_t height)
-	: mWidth(width)
-	, mHeight(height)
-{
-	if(!glfwInit()) {
-        throw Exception("Failed to initialize GLFW");
-    }
-    glfwSetErrorCallback(error_callback);
-}
-
-GlfwApplication::~GlfwApplication() {
-	glfwTerminate();
-}
-
-int GlfwApplication::run() {
-	auto pWindow = std::unique_ptr<GLFWwindow, GLFWwindowDeleter>(glfwCreateWindow(mWidth, mHeight, "ShapeShifter", nullptr, nullptr), destroyGlfwWindow);
-	if(!pWindow) {
-		throw Exception("Failed to create GLFW window");
-	}
-	glfwMakeContextCurrent(pWindow.get());
-	gladLoadGL(glfwGetProcAddress);
-	glfwSwapInterval(1);
-
-	MainLoop loop;
-	auto ctx = std::make_shared<Context>(pWindow.get());
-	std::shared_ptr<Input> pInput(Input::create(ctx));
-	std::shared_ptr<GLFWRenderer> pRenderer = std::make_shared<GLFWRenderer>(ctx);
-	pInput->registerKeyCallback([&](Key key, KeyMode keyMode) {
-			if (key == Key::ESCAPE && keyMode == KeyMode::PRESS) {
-				glfwSetWindowShouldClose(pWindow.get(), GLFW_TRUE);
-				return false;
-			}
-			if (key == Key::E && keyMode == KeyMode::PRESS) {
-				GameLogic::SelectShape();
-				pRenderer->render();
-				return false;
-			}
-			if (key == Key::W && keyMode == KeyMode::PRESS) {
-				GameLogic::Move(UP);
-				if(GameLogic::GetSomethingSelectedFlag())
-				{
-					pRenderer->render();
-				}
-				else
-				{
-					pRenderer->renderOnlyCursor(UP);
-				}
-				return false;
-			}
-			if (key == Key::A && keyMode == KeyMode::PRESS) {
-				GameLogic::Move(LEFT);
-				if(GameLogic::GetSomethingSelectedFlag())
-				{
-					pRenderer->render();
-				}
-				else
-				{
-					pRenderer->renderOnlyCursor(LEFT);
-				}
-				return false;
-			}
-			if (key == Key::S && keyMode == KeyMode::PRESS) {
-				GameLogic::Move(DOWN);
-				if(GameLogic::GetSomethingSelectedFlag())
-				{
-					pRenderer->render();
-				}
-				else
-				{
-					pRenderer->renderOnlyCursor(DOWN);
-				}
-				return false;
-			}
-			if (key == Key::D && keyMode == KeyMode::PRESS) {
-				GameLogic::Move(RIGHT);
-				if(GameLogic::GetSomethingSelectedFlag())
-				{
-					pRenderer->render();
-				}
-				else
-				{
-					pRenderer->renderOnlyCursor(RIGHT);
-				}
-				return false;
-			}
-			return true;
-		});
-
-	loop.addPolledObject(pInput);
-	loop.addPolledObject(pRenderer);
-	pRenderer->render();
-	loop.run();
-	return 0;
-}
+#include "glfw_application.hpp"
+#include "exception.hpp"
+#include "context.hpp"
+#include "input.hpp"
+#include "main_loop.hpp"
+#include "render_thread.hpp"
+#include "renderer.hpp"
+#include "frame_capture.hpp"
+#include "gl_extensions.hpp"
+#include "gl_state_cache.hpp"
+#include "asset_loader.hpp"
+#include "profiler.hpp"
+#include "camera.hpp"
+
+#include <glad/gl.h>
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+#include <memory>
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <vector>
+
+#define GLFW_WINDOW(ptr) reinterpret_cast<GLFWwindow*>(ptr)
+
+namespace opengles_workspace
+{
+typedef void(*GLFWwindowDeleter)(GLFWwindow*);
+
+void error_callback(int error, const char* description) {
+	fprintf(stderr, "GLFW error: %s\n", description);
+}
+
+void destroyGlfwWindow(GLFWwindow* window) {
+	glfwDestroyWindow(window);
+}
+
+GlfwApplication::GlfwApplication(size_t width, size_t height, AppOptions options)
+	: mWidth(width)
+	, mHeight(height)
+	, mOptions(std::move(options))
+{
+	if(!glfwInit()) {
+        throw Exception("Failed to initialize GLFW");
+    }
+    glfwSetErrorCallback(error_callback);
+
+	if (mOptions.hasSeed) {
+		Shape::SeedRandom(mOptions.seed);
+		// Constructing the game logic deals a new board from the seeded generator
+		GameLogic game;
+	}
+}
+
+GlfwApplication::~GlfwApplication() {
+	glfwTerminate();
+}
+
+int GlfwApplication::run() {
+	// Decoding runs on the worker pool while the window & context are created
+	auto assets = std::make_shared<AssetLoader>(mOptions.palettePath);
+	if (mOptions.headless) {
+		return runHeadless(assets);
+	}
+
+	// The window size is in screen coordinates, scaled up on HiDPI monitors where the platform does not do it already
+	glfwWindowHint(GLFW_SCALE_TO_MONITOR, GLFW_TRUE);
+	auto pWindow = std::unique_ptr<GLFWwindow, GLFWwindowDeleter>(glfwCreateWindow(mWidth, mHeight, "ShapeShifter", nullptr, nullptr), destroyGlfwWindow);
+	if(!pWindow) {
+		throw Exception("Failed to create GLFW window");
+	}
+	glfwMakeContextCurrent(pWindow.get());
+	gladLoadGL(glfwGetProcAddress);
+	LoadGLExtensions(glfwGetProcAddress);
+
+	MainLoop loop;
+	auto ctx = std::make_shared<Context>(pWindow.get());
+	std::shared_ptr<Input> pInput(Input::create(ctx));
+	// From here on the context belongs to the render thread, input never waits on swaps
+	// Screenshots & recordings land in the working directory unless told otherwise
+	std::string captureDir = mOptions.captureDir.empty() ? "." : mOptions.captureDir;
+	std::shared_ptr<RenderThread> pRenderThread = std::make_shared<RenderThread>(ctx, assets, pInput->surfaceSize(), mOptions.present, mOptions.render,
+		captureDir);
+	// Arrows pan, plus & minus zoom & zero shows the whole board again
+	Camera2D camera(GameLogic::gameBoardSize, GameLogic::gameBoardSize);
+	pInput->registerKeyCallback([&](Key key, KeyMode keyMode) {
+			if (key == Key::ESCAPE && keyMode == KeyMode::PRESS) {
+				glfwSetWindowShouldClose(pWindow.get(), GLFW_TRUE);
+				return false;
+			}
+			if (key == Key::E && keyMode == KeyMode::PRESS) {
+				GameLogic::SelectShape();
+				pRenderThread->submit(GameLogic::GetSnapshot());
+				return false;
+			}
+			if (key == Key::W && keyMode == KeyMode::PRESS) {
+				GameLogic::Move(UP);
+				pRenderThread->submit(GameLogic::GetSnapshot());
+				return false;
+			}
+			if (key == Key::A && keyMode == KeyMode::PRESS) {
+				GameLogic::Move(LEFT);
+				pRenderThread->submit(GameLogic::GetSnapshot());
+				return false;
+			}
+			if (key == Key::S && keyMode == KeyMode::PRESS) {
+				GameLogic::Move(DOWN);
+				pRenderThread->submit(GameLogic::GetSnapshot());
+				return false;
+			}
+			if (key == Key::D && keyMode == KeyMode::PRESS) {
+				GameLogic::Move(RIGHT);
+				pRenderThread->submit(GameLogic::GetSnapshot());
+				return false;
+			}
+			if (key == Key::F12 && keyMode == KeyMode::PRESS) {
+				pRenderThread->screenshot();
+				return false;
+			}
+			if (key == Key::F9 && keyMode == KeyMode::PRESS) {
+				pRenderThread->toggleRecording();
+				return false;
+			}
+			if (keyMode == KeyMode::PRESS) {
+				switch (key) {
+				case Key::LEFT: camera.pan(-1.0f, 0.0f); break;
+				case Key::RIGHT: camera.pan(1.0f, 0.0f); break;
+				case Key::UP: camera.pan(0.0f, -1.0f); break;
+				case Key::DOWN: camera.pan(0.0f, 1.0f); break;
+				case Key::PLUS: camera.zoomBy(1.25f); break;
+				case Key::MINUS: camera.zoomBy(0.8f); break;
+				case Key::ZERO: camera.reset(); break;
+				default: return true;
+				}
+				// A view that did not change draws nothing, the renderer finds no damage
+				pRenderThread->setView(camera.view());
+				return false;
+			}
+			return true;
+		});
+
+	pInput->registerResizeCallback([&](const SurfaceSize& size) {
+			pRenderThread->resize(size);
+		});
+
+	loop.addPolledObject(pInput);
+	loop.addPolledObject(pRenderThread);
+	pRenderThread->submit(GameLogic::GetSnapshot());
+	loop.run();
+	return 0;
+}
+
+int GlfwApplication::runHeadless(std::shared_ptr<AssetLoader> assets) {
+	// No visible surface, the context renders through OSMesa into memory
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+	auto pWindow = std::unique_ptr<GLFWwindow, GLFWwindowDeleter>(glfwCreateWindow(mWidth, mHeight, "ShapeShifter", nullptr, nullptr), destroyGlfwWindow);
+	if(!pWindow) {
+		throw Exception("Failed to create headless GLFW window");
+	}
+	glfwMakeContextCurrent(pWindow.get());
+	gladLoadGL(glfwGetProcAddress);
+	LoadGLExtensions(glfwGetProcAddress);
+	GetGLState().invalidate();
+
+	// Offscreen frames are captured at their pixel size, whatever the monitor scale
+	SurfaceSize size = { 0, 0, 1.0f };
+	glfwGetFramebufferSize(pWindow.get(), &size.width, &size.height);
+	auto ctx = std::make_shared<Context>(pWindow.get());
+	GLFWRenderer renderer(ctx, assets, size, mOptions.render);
+	// Scripted frames are spaced a 60 Hz frame apart, so captures show the same animation state on every run
+	int frame = 0;
+	renderer.setClock([&frame] { return frame / 60.0; });
+
+	// Frames are read back before they are presented, while the back buffer still holds them
+	std::vector<unsigned char> pixels;
+	renderer.setFrameCallback([&](int width, int height) {
+			PROFILE_ZONE("capture");
+			ReadFramebuffer(width, height, pixels);
+			if (!mOptions.captureDir.empty()) {
+				std::string path = mOptions.captureDir + "/frame_" + std::to_string(frame) + ".png";
+				if (!WritePng(path, width, height, pixels)) {
+					throw Exception("Failed to write frame to " + path);
+				}
+			}
+		});
+
+	auto start = std::chrono::steady_clock::now();
+	for (frame = 0; frame < mOptions.frames; frame++) {
+		PROFILE_ZONE("frame");
+		if (frame > 0) {
+			GameLogic::PlayScriptedFrame(frame);
+		}
+		renderer.render(GameLogic::GetSnapshot());
+	}
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+	printf("Rendered %d headless frames in %.2f ms (%.3f ms/frame)\n",
+		mOptions.frames, elapsed.count(), mOptions.frames ? elapsed.count() / mOptions.frames : 0.0);
+	if (mOptions.render.glStats) {
+		renderer.printGLStats();
+	}
+	return 0;
+}
 }
\ No newline at end of file
@@ -0,0 +1,252 @@
+#include <glyph_atlas.hpp>
+#include <gl_state_cache.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace opengles_workspace
+{
+	// Further than any glyph pixel from any other, squared it still fits an int
+	const int farAway = 1 << 14;
+
+	// Offset from a pixel to the nearest seed pixel found so far
+	struct SeedOffset
+	{
+		int dx;
+		int dy;
+
+		int distance2() const { return dx * dx + dy * dy; }
+	};
+
+	static void CompareSeed(std::vector<SeedOffset>& grid, int width, int rows, int x, int y, int offsetX, int offsetY)
+	{
+		int neighbourX = x + offsetX;
+		int neighbourY = y + offsetY;
+		if(neighbourX < 0 || neighbourY < 0 || neighbourX >= width || neighbourY >= rows)
+		{
+			return;
+		}
+		SeedOffset candidate = grid[neighbourY * width + neighbourX];
+		candidate.dx += offsetX;
+		candidate.dy += offsetY;
+		SeedOffset& current = grid[y * width + x];
+		if(candidate.distance2() < current.distance2())
+		{
+			current = candidate;
+		}
+	}
+
+	/// @brief Euclidean distance from every pixel to its nearest seed, two passes of the 8-neighbour sequential transform
+	/// @param grid zero offsets on seed pixels, farAway everywhere else
+	/// @return Distance in pixels of every pixel, row by row
+	static std::vector<float> DistanceTransform(std::vector<SeedOffset> grid, int width, int rows)
+	{
+		for(int y = 0; y < rows; y++)
+		{
+			for(int x = 0; x < width; x++)
+			{
+				CompareSeed(grid, width, rows, x, y, -1, 0);
+				CompareSeed(grid, width, rows, x, y, 0, -1);
+				CompareSeed(grid, width, rows, x, y, -1, -1);
+				CompareSeed(grid, width, rows, x, y, 1, -1);
+			}
+			for(int x = width - 1; x >= 0; x--)
+			{
+				CompareSeed(grid, width, rows, x, y, 1, 0);
+			}
+		}
+		for(int y = rows - 1; y >= 0; y--)
+		{
+			for(int x = width - 1; x >= 0; x--)
+			{
+				CompareSeed(grid, width, rows, x, y, 1, 0);
+				CompareSeed(grid, width, rows, x, y, 0, 1);
+				CompareSeed(grid, width, rows, x, y, -1, 1);
+				CompareSeed(grid, width, rows, x, y, 1, 1);
+			}
+			for(int x = 0; x < width; x++)
+			{
+				CompareSeed(grid, width, rows, x, y, -1, 0);
+			}
+		}
+
+		std::vector<float> distances(grid.size());
+		for(size_t pixel = 0; pixel < grid.size(); pixel++)
+		{
+			distances[pixel] = std::sqrt((float)grid[pixel].distance2());
+		}
+		return distances;
+	}
+
+	/// @brief Build the signed distance field of a glyph bitmap rasterised supersampling times larger than the field
+	/// @param bitmap 8-bit coverage bitmap from FreeType
+	/// @param scale supersampling factor of the bitmap
+	/// @param spread field distance on either side of the outline, in field pixels
+	/// @param width receives the field width, including the spread on both sides
+	/// @param rows receives the field height, including the spread on both sides
+	/// @return Field texels, 128 on the outline
+	static std::vector<unsigned char> DistanceField(const FT_Bitmap& bitmap, int scale, int spread, int& width, int& rows)
+	{
+		width = ((int)bitmap.width + scale - 1) / scale + 2 * spread;
+		rows = ((int)bitmap.rows + scale - 1) / scale + 2 * spread;
+		int sampleWidth = width * scale;
+		int sampleRows = rows * scale;
+		int margin = spread * scale;
+
+		// Distances to the nearest inside & outside samples, the outline runs between the two
+		std::vector<SeedOffset> toInside(sampleWidth * sampleRows);
+		std::vector<SeedOffset> toOutside(sampleWidth * sampleRows);
+		for(int y = 0; y < sampleRows; y++)
+		{
+			for(int x = 0; x < sampleWidth; x++)
+			{
+				int bitmapX = x - margin;
+				int bitmapY = y - margin;
+				bool inside = bitmapX >= 0 && bitmapY >= 0 && bitmapX < (int)bitmap.width && bitmapY < (int)bitmap.rows
+					&& bitmap.buffer[bitmapY * bitmap.pitch + bitmapX] >= 128;
+				toInside[y * sampleWidth + x] = inside ? SeedOffset{ 0, 0 } : SeedOffset{ farAway, farAway };
+				toOutside[y * sampleWidth + x] = inside ? SeedOffset{ farAway, farAway } : SeedOffset{ 0, 0 };
+			}
+		}
+		std::vector<float> insideDistances = DistanceTransform(std::move(toInside), sampleWidth, sampleRows);
+		std::vector<float> outsideDistances = DistanceTransform(std::move(toOutside), sampleWidth, sampleRows);
+
+		std::vector<unsigned char> field(width * rows);
+		for(int y = 0; y < rows; y++)
+		{
+			for(int x = 0; x < width; x++)
+			{
+				// The four samples around the center of the field pixel
+				float distance = 0.0f;
+				for(int sampleY = y * scale + scale / 2 - 1; sampleY <= y * scale + scale / 2; sampleY++)
+				{
+					for(int sampleX = x * scale + scale / 2 - 1; sampleX <= x * scale + scale / 2; sampleX++)
+					{
+						int sample = sampleY * sampleWidth + sampleX;
+						// Half a sample from the nearest sample of the other side is where the outline crosses
+						distance += insideDistances[sample] == 0.0f ? outsideDistances[sample] - 0.5f : 0.5f - insideDistances[sample];
+					}
+				}
+				distance /= 4.0f * scale;
+				float value = std::min(std::max(0.5f + distance / (2.0f * spread), 0.0f), 1.0f);
+				field[y * width + x] = (unsigned char)std::lround(value * 255.0f);
+			}
+		}
+		return field;
+	}
+
+	GlyphAtlas::GlyphAtlas(AssetFile font)
+		: mLibrary(nullptr)
+		, mFace(nullptr)
+		, mPenX(glyphPadding)
+		, mPenY(glyphPadding)
+		, mShelfHeight(0)
+	{
+		// Init FreeType
+		if(FT_Init_FreeType(&mLibrary))
+		{
+			fprintf(stderr, "Could not init freetype library\n");
+		}
+		// Load font as FT_Face
+		else if(!font.data || FT_New_Memory_Face(mLibrary, font.data, (FT_Long)font.size, 0, &mFace))
+		{
+			fprintf(stderr, "Could not open font\n");
+			mFace = nullptr;
+		}
+		else
+		{
+			// Set font size, rasterised larger than the fields so their outlines land between pixels
+			FT_Set_Pixel_Sizes(mFace, 0, pixelSize * supersampling);
+		}
+
+		glGenTextures(1, &mTexture);
+		GetGLState().bindTexture(0, GL_TEXTURE_2D, mTexture);
+
+		// Set the texture wrapping/filtering options (on currently bound texture)
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		// Cleared to the farthest outside distance, so the padding around glyphs samples as empty
+		std::vector<unsigned char> empty(atlasSize * atlasSize, 0);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, atlasSize, atlasSize, 0, GL_RED, GL_UNSIGNED_BYTE, empty.data());
+	}
+
+	GlyphAtlas::~GlyphAtlas()
+	{
+		GetGLState().deleteTextures(1, &mTexture);
+		if(mFace)
+		{
+			FT_Done_Face(mFace);
+		}
+		if(mLibrary)
+		{
+			FT_Done_FreeType(mLibrary);
+		}
+	}
+
+	/// @brief Get glyph of a character, generating its distance field into the atlas if it is not cached yet
+	/// @param charCode character to look up
+	/// @return Glyph with atlas texture coordinates (empty if it could not be loaded)
+	const GlyphAtlas::Glyph& GlyphAtlas::glyph(unsigned long charCode)
+	{
+		auto cached = mGlyphs.find(charCode);
+		if(cached != mGlyphs.end())
+		{
+			return cached->second;
+		}
+
+		Glyph& glyph = mGlyphs[charCode];
+		glyph = { 0, 0, 0.0f, 0.0f, 0.0f, 0.0f };
+
+		// Load glyph of character
+		if(!mFace || FT_Load_Char(mFace, charCode, FT_LOAD_RENDER))
+		{
+			fprintf(stderr, "Could not load character '%lu'\n", charCode);
+			return glyph;
+		}
+		FT_Bitmap bitmap = mFace->glyph->bitmap;
+		if(bitmap.width == 0 || bitmap.rows == 0)
+		{
+			return glyph;
+		}
+		int width;
+		int rows;
+		std::vector<unsigned char> field = DistanceField(bitmap, supersampling, spread, width, rows);
+
+		// Start a new shelf when the glyph does not fit the current one
+		if(mPenX + width + glyphPadding > atlasSize)
+		{
+			mPenX = glyphPadding;
+			mPenY += mShelfHeight + glyphPadding;
+			mShelfHeight = 0;
+		}
+		if(mPenY + rows + glyphPadding > atlasSize)
+		{
+			fprintf(stderr, "Glyph atlas is full, could not add character '%lu'\n", charCode);
+			return glyph;
+		}
+
+		glyph.width = width;
+		glyph.rows = rows;
+		glyph.leftU = (float)mPenX / atlasSize;
+		glyph.topV = (float)mPenY / atlasSize;
+		glyph.rightU = (float)(mPenX + width) / atlasSize;
+		glyph.bottomV = (float)(mPenY + rows) / atlasSize;
+
+		GetGLState().bindTexture(0, GL_TEXTURE_2D, mTexture);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, mPenX, mPenY, width, rows, GL_RED, GL_UNSIGNED_BYTE, field.data());
+
+		mPenX += width + glyphPadding;
+		if(rows > mShelfHeight)
+		{
+			mShelfHeight = rows;
+		}
+		return glyph;
+	}
+}
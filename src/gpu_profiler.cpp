@@ -0,0 +1,132 @@
+#include <gpu_profiler.hpp>
+#include <gl_extensions.hpp>
+
+namespace opengles_workspace
+{
+	// Zones still waiting for results, more means the GPU stopped reporting & new zones are dropped
+	const size_t maxPendingZones = 256;
+	// The GPU & CPU clocks drift apart, line them up again every few seconds
+	const int calibrationInterval = 300;
+
+	GpuProfiler::GpuProfiler()
+		: mEnabled(Profiler::IsEnabled() && GetGLExtensions().timerQuery)
+		, mTrack(nullptr)
+		, mFirstZone(0)
+		, mClockOffset(0)
+		, mCollectsSinceCalibration(0)
+	{
+		if(mEnabled)
+		{
+			mTrack = &Profiler::CreateTrack("GPU");
+			calibrate();
+		}
+	}
+
+	GpuProfiler::~GpuProfiler()
+	{
+		if(!mQueries.empty())
+		{
+			glDeleteQueries((GLsizei)mQueries.size(), mQueries.data());
+		}
+	}
+
+	/// @brief Start a zone with a timestamp query, zones may nest
+	/// @param name zone name, must outlive the profiler (a string literal)
+	/// @return Zone to pass to endZone, -1 if it is not timed
+	int GpuProfiler::beginZone(const char* name)
+	{
+		if(!mEnabled || mZones.size() >= maxPendingZones)
+		{
+			return -1;
+		}
+		GLuint query = acquireQuery();
+		GetGLExtensions().QueryCounter(query, GL_TIMESTAMP);
+		mZones.push_back({ name, query, 0 });
+		return mFirstZone + (int)mZones.size() - 1;
+	}
+
+	/// @brief End a zone with a second timestamp query
+	/// @param zone zone returned by beginZone
+	void GpuProfiler::endZone(int zone)
+	{
+		if(zone < mFirstZone)
+		{
+			return;
+		}
+		GLuint query = acquireQuery();
+		GetGLExtensions().QueryCounter(query, GL_TIMESTAMP);
+		mZones[zone - mFirstZone].end = query;
+	}
+
+	void GpuProfiler::collect()
+	{
+		if(!mEnabled)
+		{
+			return;
+		}
+		const GLExtensions& extensions = GetGLExtensions();
+
+		// A disjoint operation (e.g. a frequency change) makes the results in flight meaningless
+		GLint disjoint = 0;
+		if(extensions.timerQueryDisjoint)
+		{
+			glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+		}
+
+		while(!mZones.empty() && mZones.front().end)
+		{
+			// Queries complete in order, the end of the oldest zone is the first result to arrive
+			Zone& zone = mZones.front();
+			GLint available = 0;
+			glGetQueryObjectiv(zone.end, GL_QUERY_RESULT_AVAILABLE, &available);
+			if(!available)
+			{
+				break;
+			}
+
+			GLuint64 begin = 0;
+			GLuint64 end = 0;
+			extensions.GetQueryObjectui64v(zone.begin, GL_QUERY_RESULT, &begin);
+			extensions.GetQueryObjectui64v(zone.end, GL_QUERY_RESULT, &end);
+			if(!disjoint && end >= begin)
+			{
+				mTrack->record(zone.name, (int64_t)begin + mClockOffset, (int64_t)(end - begin));
+			}
+
+			mFreeQueries.push_back(zone.begin);
+			mFreeQueries.push_back(zone.end);
+			mZones.pop_front();
+			mFirstZone++;
+		}
+
+		if(disjoint || ++mCollectsSinceCalibration >= calibrationInterval)
+		{
+			calibrate();
+		}
+	}
+
+	/// @brief Reuse a finished query or create a new one
+	/// @return Query object
+	GLuint GpuProfiler::acquireQuery()
+	{
+		if(!mFreeQueries.empty())
+		{
+			GLuint query = mFreeQueries.back();
+			mFreeQueries.pop_back();
+			return query;
+		}
+		GLuint query = 0;
+		glGenQueries(1, &query);
+		mQueries.push_back(query);
+		return query;
+	}
+
+	/// @brief Line up the GPU clock with the profiler clock, so both tracks share one timeline
+	void GpuProfiler::calibrate()
+	{
+		GLint64 gpuNow = 0;
+		GetGLExtensions().GetInteger64v(GL_TIMESTAMP, &gpuNow);
+		mClockOffset = Profiler::Now() - gpuNow;
+		mCollectsSinceCalibration = 0;
+	}
+}
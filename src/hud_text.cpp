@@ -0,0 +1,137 @@
+#include <hud_text.hpp>
+
+#include <cassert>
+
+namespace opengles_workspace
+{
+	HudText::HudText(GlyphAtlas& glyphs, SpriteBatch& sprites, int maxLabels, int maxLabelLength)
+		: mGlyphs(glyphs)
+		, mSprites(sprites)
+		, mMaxLabels(maxLabels)
+		, mMaxLabelLength(maxLabelLength)
+		, mGlyphScaleX(0.0f)
+		, mGlyphScaleY(0.0f)
+	{
+		// Every label owns a fixed slot of quads
+		mVertices.resize(maxLabels * maxLabelLength * 4, { 0.0f, 0.0f, 0.0f, 0.0f });
+	}
+
+	/// @brief Add an empty label
+	/// @param x left edge of the first character cell
+	/// @param y top edge of the character cells
+	/// @param cellWidth width of one character cell
+	/// @param cellHeight height of one character cell
+	/// @return Label handle for setText
+	int HudText::addLabel(float x, float y, float cellWidth, float cellHeight)
+	{
+		assert((int)mLabels.size() < mMaxLabels);
+		mLabels.push_back({ x, y, cellWidth, cellHeight, "" });
+		return (int)mLabels.size() - 1;
+	}
+
+	/// @brief Move a label to new character cells
+	/// @param label label handle
+	/// @param x left edge of the first character cell
+	/// @param y top edge of the character cells
+	/// @param cellWidth width of one character cell
+	/// @param cellHeight height of one character cell
+	void HudText::moveLabel(int label, float x, float y, float cellWidth, float cellHeight)
+	{
+		Label& hudLabel = mLabels[label];
+		hudLabel.x = x;
+		hudLabel.y = y;
+		hudLabel.cellWidth = cellWidth;
+		hudLabel.cellHeight = cellHeight;
+		layout(label);
+	}
+
+	/// @brief Change the size glyph bitmaps are drawn at
+	/// @param glyphScaleX normalized device width of one bitmap pixel
+	/// @param glyphScaleY normalized device height of one bitmap pixel
+	void HudText::setGlyphScale(float glyphScaleX, float glyphScaleY)
+	{
+		mGlyphScaleX = glyphScaleX;
+		mGlyphScaleY = glyphScaleY;
+		for(int label = 0; label < (int)mLabels.size(); label++)
+		{
+			layout(label);
+		}
+	}
+
+	/// @brief Change the text of a label
+	/// @param label label handle
+	/// @param text new text, cut to the maximum label length
+	void HudText::setText(int label, const std::string& text)
+	{
+		std::string newText = text.substr(0, mMaxLabelLength);
+		if(mLabels[label].text == newText)
+		{
+			return;
+		}
+		mLabels[label].text = newText;
+		layout(label);
+	}
+
+	/// @brief Rebuild the quads of one label, the other labels keep theirs
+	/// @param label label handle
+	void HudText::layout(int label)
+	{
+		const Label& hudLabel = mLabels[label];
+		int firstVertex = label * mMaxLabelLength * 4;
+		QuadVertex* vertices = &mVertices[firstVertex];
+
+		float X = hudLabel.x;
+		float Y = hudLabel.y;
+		for(int character = 0; character < (int)hudLabel.text.size(); character++)
+		{
+			QuadVertex* quad = vertices + character * 4;
+			const GlyphAtlas::Glyph& glyph = mGlyphs.glyph((unsigned char)hudLabel.text[character]);
+
+			// Get bitmap dimensions
+			float bitmapWidth = glyph.width * mGlyphScaleX;
+			float bitmapHeight = glyph.rows * mGlyphScaleY;
+
+			// Set center offsets to correctly draw the character in the center of designated coordinates
+			float centerOffsetX = (hudLabel.cellWidth - bitmapWidth)/2.0f;
+			float leftX = X + centerOffsetX;
+			float rightX = leftX + bitmapWidth;
+
+			float centerOffsetY = (hudLabel.cellHeight - bitmapHeight)/2.0f;
+			float topY = Y - centerOffsetY;
+			float bottomY = topY - bitmapHeight;
+
+			quad[0] = { leftX,	topY,		glyph.leftU,	glyph.topV };		// Top left
+			quad[1] = { rightX,	topY,		glyph.rightU,	glyph.topV };		// Top right
+			quad[2] = { leftX,	bottomY,	glyph.leftU,	glyph.bottomV };	// Bottom left
+			quad[3] = { rightX,	bottomY,	glyph.rightU,	glyph.bottomV };	// Bottom right
+
+			X += hudLabel.cellWidth;
+		}
+	}
+
+	/// @brief Copy the quads of every label into a new sprite batch & record its draw
+	/// @param commands command buffer of the current frame
+	/// @param program text program to draw with
+	void HudText::record(RenderCommandBuffer& commands, GLuint program)
+	{
+		mSprites.begin();
+		for(int label = 0; label < (int)mLabels.size(); label++)
+		{
+			const QuadVertex* vertices = &mVertices[label * mMaxLabelLength * 4];
+			for(int character = 0; character < (int)mLabels[label].text.size(); character++)
+			{
+				const QuadVertex* quad = vertices + character * 4;
+				mSprites.addQuad(quad[0].x, quad[0].y, quad[3].x, quad[3].y, quad[0].u, quad[0].v, quad[3].u, quad[3].v);
+			}
+		}
+
+		DrawCommand* command = mSprites.record(commands, RenderLayer::HUD);
+		if(!command)
+		{
+			return;
+		}
+		command->program = program;
+		command->textureTarget = GL_TEXTURE_2D;
+		command->texture = mGlyphs.texture();
+	}
+}
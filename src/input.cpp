@@ -1,109 +1,165 @@
-#include <input.hpp>
-#include <exception.hpp>
-#include <vector>
-#include <cassert>
-#include <optional>
-#include <string>
-
-#include <glad/gl.h>
-#define GLFW_INCLUDE_NONE
-#include <GLFW/glfw3.h>
-
-#define GLFW_WINDOW(ptr) reinterpret_cast<GLFWwindow*>(ptr)
-
-namespace opengles_workspace {
-
-	static void local_key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
-
-	class GLFWInput : public Input
-	{
-	public:
-		GLFWInput(std::shared_ptr<Context> context)
-			: Input(std::move(context))
-		{
-			glfwSetWindowUserPointer(window(), this);
-			glfwSetKeyCallback(window(), local_key_callback);
-		}
-
-		~GLFWInput() {
-			glfwSetWindowUserPointer(window(), nullptr);
-		}
-
-		void registerKeyCallback(KeyCallback keyCallback) override {
-			mKeyCallbacks.emplace_back(std::move(keyCallback));
-		}
-
-		bool poll() override {
-			if (glfwWindowShouldClose(window())) {
-				return false;
-			}
-			glfwPollEvents();
-			return true;
-		}
-
-		void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
-			//fprintf(stderr, "key_callback(key=%d, scancode=%d, action=%d, mods=%d\n", key, scancode, action, mods);
-			for (auto& cb : mKeyCallbacks) {
-				auto translatedKey = toKey(key);
-				if (!translatedKey) {
-					fprintf(stderr, "Ingore key: non-convertible");
-					break;
-				}
-				if (cb(*translatedKey, toKeyMode(action))) {
-					break;
-				}
-			}
-		}
-	private:
-		std::vector<KeyCallback> mKeyCallbacks;
-
-		GLFWwindow* window() const { return static_cast<GLFWwindow*>(mContext->window()); }
-		std::optional<Key> toKey(int key) {
-			switch (key) {
-			case GLFW_KEY_ESCAPE:
-				return Key::ESCAPE;
-			case GLFW_KEY_LEFT:
-				return Key::LEFT;
-			case GLFW_KEY_RIGHT:
-				return Key::RIGHT;
-			case GLFW_KEY_DOWN:
-				return Key::DOWN;
-			case GLFW_KEY_SPACE:
-				return Key::SPACE;
-			case GLFW_KEY_W:
-				return Key::W;
-			case GLFW_KEY_A:
-				return Key::A;
-			case GLFW_KEY_S:
-				return Key::S;
-			case GLFW_KEY_D:
-				return Key::D;
-			case GLFW_KEY_E:
-				return Key::E;
-			default:
-				return {};
-			}
-		}
-		KeyMode toKeyMode(int keyMode) {
-			switch (keyMode) {
-			case GLFW_PRESS:
-			case GLFW_REPEAT:
-				return KeyMode::PRESS;
-			case GLFW_RELEASE:
-				return KeyMode::RELEASE;
-			default:
-				throw Exception("Invalid KeyMode mode=" + std::to_string(keyMode));
-			}
-		}
-	};
-
-	static void local_key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
-		GLFWInput* input = static_cast<GLFWInput*>(glfwGetWindowUserPointer(window));
-		assert(input);
-		input->key_callback(window, key, scancode, action, mods);
-	}
-
-	std::unique_ptr<Input> Input::create(std::shared_ptr<Context> context) {
-		return std::make_unique<GLFWInput>(std::move(context));
-	}
+#include <input.hpp>
+#include <exception.hpp>
+#include <profiler.hpp>
+#include <vector>
+#include <cassert>
+#include <optional>
+#include <string>
+
+#include <glad/gl.h>
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+#define GLFW_WINDOW(ptr) reinterpret_cast<GLFWwindow*>(ptr)
+
+namespace opengles_workspace {
+
+	static void local_key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+	static void local_framebuffer_size_callback(GLFWwindow* window, int /*width*/, int /*height*/);
+	static void local_content_scale_callback(GLFWwindow* window, float /*xscale*/, float /*yscale*/);
+
+	class GLFWInput : public Input
+	{
+	public:
+		GLFWInput(std::shared_ptr<Context> context)
+			: Input(std::move(context))
+		{
+			glfwSetWindowUserPointer(window(), this);
+			glfwSetKeyCallback(window(), local_key_callback);
+			glfwSetFramebufferSizeCallback(window(), local_framebuffer_size_callback);
+			glfwSetWindowContentScaleCallback(window(), local_content_scale_callback);
+		}
+
+		~GLFWInput() {
+			glfwSetKeyCallback(window(), nullptr);
+			glfwSetFramebufferSizeCallback(window(), nullptr);
+			glfwSetWindowContentScaleCallback(window(), nullptr);
+			glfwSetWindowUserPointer(window(), nullptr);
+		}
+
+		void registerKeyCallback(KeyCallback keyCallback) override {
+			mKeyCallbacks.emplace_back(std::move(keyCallback));
+		}
+
+		void registerResizeCallback(ResizeCallback resizeCallback) override {
+			mResizeCallbacks.emplace_back(std::move(resizeCallback));
+		}
+
+		SurfaceSize surfaceSize() const override {
+			SurfaceSize size;
+			glfwGetFramebufferSize(window(), &size.width, &size.height);
+			float yscale;
+			glfwGetWindowContentScale(window(), &size.contentScale, &yscale);
+			return size;
+		}
+
+		bool poll() override {
+			if (glfwWindowShouldClose(window())) {
+				return false;
+			}
+			glfwPollEvents();
+			return true;
+		}
+
+		void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+			//fprintf(stderr, "key_callback(key=%d, scancode=%d, action=%d, mods=%d\n", key, scancode, action, mods);
+			PROFILE_ZONE("key callback");
+			for (auto& cb : mKeyCallbacks) {
+				auto translatedKey = toKey(key);
+				if (!translatedKey) {
+					fprintf(stderr, "Ingore key: non-convertible");
+					break;
+				}
+				if (cb(*translatedKey, toKeyMode(action))) {
+					break;
+				}
+			}
+		}
+		// Both events report the full surface size, a scale change may come without a framebuffer resize
+		void resize_callback() {
+			SurfaceSize size = surfaceSize();
+			for (auto& cb : mResizeCallbacks) {
+				cb(size);
+			}
+		}
+	private:
+		std::vector<KeyCallback> mKeyCallbacks;
+		std::vector<ResizeCallback> mResizeCallbacks;
+
+		GLFWwindow* window() const { return static_cast<GLFWwindow*>(mContext->window()); }
+		std::optional<Key> toKey(int key) {
+			switch (key) {
+			case GLFW_KEY_ESCAPE:
+				return Key::ESCAPE;
+			case GLFW_KEY_LEFT:
+				return Key::LEFT;
+			case GLFW_KEY_RIGHT:
+				return Key::RIGHT;
+			case GLFW_KEY_DOWN:
+				return Key::DOWN;
+			case GLFW_KEY_SPACE:
+				return Key::SPACE;
+			case GLFW_KEY_W:
+				return Key::W;
+			case GLFW_KEY_A:
+				return Key::A;
+			case GLFW_KEY_S:
+				return Key::S;
+			case GLFW_KEY_D:
+				return Key::D;
+			case GLFW_KEY_E:
+				return Key::E;
+			case GLFW_KEY_UP:
+				return Key::UP;
+			case GLFW_KEY_EQUAL:
+			case GLFW_KEY_KP_ADD:
+				return Key::PLUS;
+			case GLFW_KEY_MINUS:
+			case GLFW_KEY_KP_SUBTRACT:
+				return Key::MINUS;
+			case GLFW_KEY_0:
+			case GLFW_KEY_KP_0:
+				return Key::ZERO;
+			case GLFW_KEY_F9:
+				return Key::F9;
+			case GLFW_KEY_F12:
+				return Key::F12;
+			default:
+				return {};
+			}
+		}
+		KeyMode toKeyMode(int keyMode) {
+			switch (keyMode) {
+			case GLFW_PRESS:
+			case GLFW_REPEAT:
+				return KeyMode::PRESS;
+			case GLFW_RELEASE:
+				return KeyMode::RELEASE;
+			default:
+				throw Exception("Invalid KeyMode mode=" + std::to_string(keyMode));
+			}
+		}
+	};
+
+	static void local_key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+		GLFWInput* input = static_cast<GLFWInput*>(glfwGetWindowUserPointer(window));
+		assert(input);
+		input->key_callback(window, key, scancode, action, mods);
+	}
+
+	static void local_framebuffer_size_callback(GLFWwindow* window, int /*width*/, int /*height*/) {
+		GLFWInput* input = static_cast<GLFWInput*>(glfwGetWindowUserPointer(window));
+		assert(input);
+		input->resize_callback();
+	}
+
+	static void local_content_scale_callback(GLFWwindow* window, float /*xscale*/, float /*yscale*/) {
+		GLFWInput* input = static_cast<GLFWInput*>(glfwGetWindowUserPointer(window));
+		assert(input);
+		input->resize_callback();
+	}
+
+	std::unique_ptr<Input> Input::create(std::shared_ptr<Context> context) {
+		return std::make_unique<GLFWInput>(std::move(context));
+	}
 }
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include <layout.hpp>
+#include <game_logic.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace opengles_workspace
+{
+	// The score row above the board plus the board rows, & half a cell of margin left & right of the board
+	const int layoutRows = GameLogic::gameBoardSize + 1;
+	const int layoutColumns = GameLogic::gameBoardSize + 1;
+	// Text is a little taller than a cell, the em box includes room for descenders
+	const float textCellScale = 1.2f;
+
+	Layout::Layout()
+		: mSurface({ 0, 0, 0.0f })
+		, mView({ 1.0f, GameLogic::gameBoardSize * 0.5f, GameLogic::gameBoardSize * 0.5f })
+		, mCellPixels(0)
+		, mCellWidth(0.0f)
+		, mCellHeight(0.0f)
+		, mBoardX(0.0f)
+		, mBoardY(0.0f)
+		, mBoardRight(0.0f)
+		, mBoardBottom(0.0f)
+		, mTileWidth(0.0f)
+		, mTileHeight(0.0f)
+		, mViewX(0.0f)
+		, mViewY(0.0f)
+		, mFirstVisibleColumn(0)
+		, mFirstVisibleRow(0)
+		, mVisibleColumns(GameLogic::gameBoardSize)
+		, mVisibleRows(GameLogic::gameBoardSize)
+		, mScoreX(0.0f)
+		, mScoreY(0.0f)
+		, mTextPixelSize(0.0f)
+	{
+	}
+
+	/// @brief Fit the layout grid into a framebuffer
+	/// @param size framebuffer size & content scale
+	/// @return true if the geometry changed
+	bool Layout::resize(const SurfaceSize& size)
+	{
+		if(size.width == mSurface.width && size.height == mSurface.height && size.contentScale == mSurface.contentScale)
+		{
+			return false;
+		}
+		mSurface = size;
+
+		// Whole-pixel cells keep cell edges on pixel boundaries, the rest of the framebuffer is left empty around the grid
+		mCellPixels = std::max(1, std::min(size.width / layoutColumns, size.height / layoutRows));
+		int gridLeft = (size.width - mCellPixels * layoutColumns) / 2;
+		int gridTop = (size.height - mCellPixels * layoutRows) / 2;
+
+		float pixelWidth = 2.0f / std::max(1, size.width);
+		float pixelHeight = 2.0f / std::max(1, size.height);
+		mCellWidth = mCellPixels * pixelWidth;
+		mCellHeight = mCellPixels * pixelHeight;
+		mScoreX = -1.0f + (gridLeft + mCellPixels / 2) * pixelWidth;
+		mScoreY = 1.0f - gridTop * pixelHeight;
+		mBoardX = mScoreX;
+		mBoardY = mScoreY - mCellHeight;
+		mBoardRight = mBoardX + mCellWidth * GameLogic::gameBoardSize;
+		mBoardBottom = mBoardY - mCellHeight * GameLogic::gameBoardSize;
+
+		mTextPixelSize = mCellPixels * textCellScale;
+		applyView();
+		return true;
+	}
+
+	/// @brief Look at another part of the board
+	/// @param view zoom & center of the camera
+	/// @return true if the geometry changed
+	bool Layout::setView(const CameraView& view)
+	{
+		if(view.zoom == mView.zoom && view.centerColumn == mView.centerColumn && view.centerRow == mView.centerRow)
+		{
+			return false;
+		}
+		mView = view;
+		applyView();
+		return true;
+	}
+
+	/// @brief Place the board cells through the camera & find the cells inside the board area
+	void Layout::applyView()
+	{
+		const int boardSize = GameLogic::gameBoardSize;
+		// The view spans boardSize / zoom cells, which is the whole board at a zoom of 1
+		float halfCells = boardSize * 0.5f / mView.zoom;
+		float firstColumn = mView.centerColumn - halfCells;
+		float firstRow = mView.centerRow - halfCells;
+
+		mTileWidth = mCellWidth * mView.zoom;
+		mTileHeight = mCellHeight * mView.zoom;
+		mViewX = mBoardX - mTileWidth * firstColumn;
+		mViewY = mBoardY + mTileHeight * firstRow;
+
+		mFirstVisibleColumn = std::min(std::max((int)std::floor(firstColumn), 0), boardSize - 1);
+		mFirstVisibleRow = std::min(std::max((int)std::floor(firstRow), 0), boardSize - 1);
+		// A view past the top or left edge sees no cells, not a negative number of them
+		mVisibleColumns = std::max(std::min((int)std::ceil(firstColumn + halfCells * 2.0f), boardSize) - mFirstVisibleColumn, 0);
+		mVisibleRows = std::max(std::min((int)std::ceil(firstRow + halfCells * 2.0f), boardSize) - mFirstVisibleRow, 0);
+	}
+}
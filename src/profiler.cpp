@@ -0,0 +1,126 @@
+#include <profiler.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace opengles_workspace
+{
+	// Enough for minutes of frames with a dozen zones each, a full track drops new events
+	const uint32_t trackCapacity = 1 << 18;
+
+	std::atomic<bool> Profiler::enabled(false);
+
+	static std::chrono::steady_clock::time_point epoch;
+
+	// Tracks only ever get added, so pointers handed out stay valid until exit
+	static std::mutex tracksMutex;
+	static std::vector<std::unique_ptr<ProfileTrack>> tracks;
+
+	static thread_local ProfileTrack* threadTrack = nullptr;
+	static thread_local const char* threadName = "thread";
+
+	ProfileTrack::ProfileTrack(std::string name, uint32_t id, uint32_t capacity)
+		: mName(std::move(name))
+		, mId(id)
+		, mCapacity(capacity)
+		, mEvents(new ProfileEvent[capacity])
+		, mCount(0)
+		, mDropped(0)
+	{
+	}
+
+	/// @brief Append an event, only ever called by the thread owning the track
+	/// @param name zone name, must outlive the profiler (a string literal)
+	/// @param start start time in nanoseconds
+	/// @param duration duration in nanoseconds
+	void ProfileTrack::record(const char* name, int64_t start, int64_t duration)
+	{
+		uint32_t index = mCount.load(std::memory_order_relaxed);
+		if(index >= mCapacity)
+		{
+			mDropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		mEvents[index] = { name, start, duration };
+		// Publish the event to the trace writer
+		mCount.store(index + 1, std::memory_order_release);
+	}
+
+	void Profiler::Enable()
+	{
+		epoch = std::chrono::steady_clock::now();
+		enabled.store(true);
+	}
+
+	int64_t Profiler::Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+	}
+
+	/// @brief Track of the calling thread, only zones recorded while the profiler is enabled get here
+	/// @return Track, created under the thread name on first use
+	ProfileTrack& Profiler::ThreadTrack()
+	{
+		if(!threadTrack)
+		{
+			threadTrack = &CreateTrack(threadName);
+		}
+		return *threadTrack;
+	}
+
+	/// @brief Name the track of the calling thread, the track itself is only created once a zone is recorded
+	/// @param name thread name, must outlive the thread (a string literal)
+	void Profiler::SetThreadName(const char* name)
+	{
+		threadName = name;
+	}
+
+	/// @brief Add a track
+	/// @param name track name shown in the trace
+	/// @return Track, valid until exit
+	ProfileTrack& Profiler::CreateTrack(const char* name)
+	{
+		std::lock_guard<std::mutex> lock(tracksMutex);
+		tracks.emplace_back(new ProfileTrack(name, (uint32_t)tracks.size() + 1, trackCapacity));
+		return *tracks.back();
+	}
+
+	/// @brief Write every recorded event as Chrome trace_event JSON, complete ("X") events in microseconds
+	/// @param path file to write
+	/// @return true if the file was written
+	bool Profiler::WriteTrace(const std::string& path)
+	{
+		FILE* file = fopen(path.c_str(), "w");
+		if(!file)
+		{
+			fprintf(stderr, "Could not write trace [%s]\n", path.c_str());
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(tracksMutex);
+		fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+		bool first = true;
+		for(const std::unique_ptr<ProfileTrack>& track : tracks)
+		{
+			fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+				first ? "" : ",\n", track->id(), track->name().c_str());
+			first = false;
+
+			uint32_t count = track->size();
+			for(uint32_t index = 0; index < count; index++)
+			{
+				const ProfileEvent& event = track->event(index);
+				fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+					event.name, track->id(), event.start / 1000.0, event.duration / 1000.0);
+			}
+			if(track->dropped())
+			{
+				fprintf(stderr, "Trace track [%s] was full, %u events were dropped\n", track->name().c_str(), track->dropped());
+			}
+		}
+		fprintf(file, "\n]}\n");
+		return fclose(file) == 0;
+	}
+}
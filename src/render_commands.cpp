@@ -0,0 +1,124 @@
+#include <render_commands.hpp>
+#include <exception.hpp>
+#include <gl_state_cache.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+namespace opengles_workspace
+{
+	FrameArena::FrameArena(size_t capacity)
+		: mMemory(new unsigned char[capacity])
+		, mCapacity(capacity)
+		, mUsed(0)
+	{}
+
+	void* FrameArena::allocateBytes(size_t size, size_t alignment)
+	{
+		uintptr_t base = reinterpret_cast<uintptr_t>(mMemory.get());
+		uintptr_t aligned = (base + mUsed + alignment - 1) & ~(uintptr_t)(alignment - 1);
+		size_t end = aligned - base + size;
+		if(end > mCapacity)
+		{
+			throw Exception("Frame arena exhausted, capacity=" + std::to_string(mCapacity));
+		}
+		mUsed = end;
+		return reinterpret_cast<void*>(aligned);
+	}
+
+	RenderCommandBuffer::RenderCommandBuffer(size_t arenaCapacity, size_t maxCommands)
+		: mArena(arenaCapacity)
+		, mMaxCommands(maxCommands)
+	{
+		mCommands.reserve(maxCommands);
+	}
+
+	void RenderCommandBuffer::reset()
+	{
+		mCommands.clear();
+		mArena.reset();
+	}
+
+	/// @brief Record a draw command in the frame arena
+	/// @param layer draw order layer
+	/// @param uniformCount number of uniform values the command sets
+	/// @return Zero initialised command with its uniform slots allocated
+	DrawCommand& RenderCommandBuffer::addDraw(RenderLayer layer, uint32_t uniformCount)
+	{
+		if(mCommands.size() >= mMaxCommands)
+		{
+			throw Exception("Too many render commands, max=" + std::to_string(mMaxCommands));
+		}
+		DrawCommand* command = mArena.allocate<DrawCommand>(1);
+		*command = DrawCommand();
+		command->layer = layer;
+		command->instanceCount = 1;
+		command->uniforms = uniformCount ? mArena.allocate<UniformCommand>(uniformCount) : nullptr;
+		command->uniformCount = uniformCount;
+		mCommands.push_back(command);
+		return *command;
+	}
+
+	void RenderCommandBuffer::sort()
+	{
+		// layer:8 | program:16 | texture:24 | vertex array:16
+		for(DrawCommand* command : mCommands)
+		{
+			command->sortKey = ((uint64_t)command->layer << 56)
+				| ((uint64_t)(command->program & 0xFFFF) << 40)
+				| ((uint64_t)(command->texture & 0xFFFFFF) << 16)
+				| (uint64_t)(command->vertexArray & 0xFFFF);
+		}
+		// Stable, so equal state keeps the order it was recorded in
+		std::stable_sort(mCommands.begin(), mCommands.end(),
+			[](const DrawCommand* first, const DrawCommand* second) { return first->sortKey < second->sortKey; });
+	}
+
+	/// @brief Issue every recorded command, the state cache drops binds & uniforms that are already set
+	/// @param commands sorted command buffer
+	void GLCommandBackend::submit(const RenderCommandBuffer& commands)
+	{
+		// The cache carries the state over between damage rectangles & frames, a repeated submit only issues the draws
+		GLStateCache& state = GetGLState();
+		for(const DrawCommand* command : commands.commands())
+		{
+			// A culled draw with nothing in view, the non-instanced path would still draw one instance
+			if(command->instanceCount <= 0)
+			{
+				continue;
+			}
+			state.useProgram(command->program);
+			if(command->texture)
+			{
+				state.bindTexture(0, command->textureTarget, command->texture);
+			}
+			if(command->lookupTexture)
+			{
+				state.bindTexture(1, GL_TEXTURE_2D, command->lookupTexture);
+			}
+			if(command->uniformBuffer)
+			{
+				state.bindBufferBase(GL_UNIFORM_BUFFER, 0, command->uniformBuffer);
+			}
+			state.bindVertexArray(command->vertexArray);
+
+			for(uint32_t index = 0; index < command->uniformCount; index++)
+			{
+				const UniformCommand& uniform = command->uniforms[index];
+				state.uniform(uniform.location, uniform.components, uniform.values);
+			}
+
+			// Offset into the element buffer bound with the vertex array
+			const void* indices = (const void*)(command->first * sizeof(GLushort));
+			if(command->instanceCount > 1)
+			{
+				glDrawElementsInstanced(command->mode, command->count, GL_UNSIGNED_SHORT, indices, command->instanceCount);
+			}
+			else
+			{
+				glDrawElements(command->mode, command->count, GL_UNSIGNED_SHORT, indices);
+			}
+		}
+	}
+}
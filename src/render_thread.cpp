@@ -0,0 +1,246 @@
+#include <render_thread.hpp>
+#include <renderer.hpp>
+#include <profiler.hpp>
+#include <gl_state_cache.hpp>
+#include <frame_recorder.hpp>
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+namespace opengles_workspace
+{
+	// How long captured frames may wait for the next frame to collect them, without one they are collected anyway
+	const std::chrono::milliseconds captureCollectInterval(20);
+
+	RenderThread::RenderThread(std::shared_ptr<Context> context, std::shared_ptr<AssetLoader> assets, const SurfaceSize& size, PresentOptions present, RenderOptions render,
+		std::string captureDir)
+		: mContext(std::move(context))
+		, mAssets(std::move(assets))
+		, mPresent(present)
+		, mRender(render)
+		, mCaptureDir(std::move(captureDir))
+		, mSize(size)
+		, mPendingScreenshot(false)
+		, mPendingRecordToggle(false)
+		, mStopping(false)
+	{
+		// Monitors can only be queried on the main thread
+		GLFWmonitor* monitor = glfwGetPrimaryMonitor();
+		const GLFWvidmode* videoMode = monitor ? glfwGetVideoMode(monitor) : nullptr;
+		double refreshPeriodMs = 1000.0 / (videoMode && videoMode->refreshRate > 0 ? videoMode->refreshRate : 60);
+		// A synced frame is scanned out over the next refresh, a torn one lands half way through on average
+		bool synced = mPresent.mode == PresentMode::VSYNC || mPresent.mode == PresentMode::ADAPTIVE;
+		mScanOutMs = synced ? refreshPeriodMs : refreshPeriodMs * 0.5;
+		// Recordings get a frame every refresh, or every frame the limit lets through
+		mRecordRate = mPresent.mode == PresentMode::LIMITED ? mPresent.frameLimit : (int)(1000.0 / refreshPeriodMs + 0.5);
+
+		// The context has to be released by the creating thread before another one can make it current
+		glfwMakeContextCurrent(nullptr);
+		mThread = std::thread(&RenderThread::run, this);
+	}
+
+	RenderThread::~RenderThread()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mStopping = true;
+		}
+		mCondition.notify_one();
+		mThread.join();
+	}
+
+	/// @brief Queue a snapshot for drawing, never waits for the GPU
+	/// @param snapshot game state to draw next
+	void RenderThread::submit(const GameSnapshot& snapshot)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (!mPendingSnapshot && !mPendingSize && !mPendingView) {
+				mPendingInput = std::chrono::steady_clock::now();
+			}
+			mPendingSnapshot = snapshot;
+		}
+		mCondition.notify_one();
+	}
+
+	/// @brief Queue a framebuffer resize, applied before the next frame is drawn
+	/// @param size new framebuffer size & content scale
+	void RenderThread::resize(const SurfaceSize& size)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (!mPendingSnapshot && !mPendingSize && !mPendingView) {
+				mPendingInput = std::chrono::steady_clock::now();
+			}
+			mPendingSize = size;
+		}
+		mCondition.notify_one();
+	}
+
+	/// @brief Queue a camera view, applied before the next frame is drawn
+	/// @param view zoom & center of the camera
+	void RenderThread::setView(const CameraView& view)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (!mPendingSnapshot && !mPendingSize && !mPendingView) {
+				mPendingInput = std::chrono::steady_clock::now();
+			}
+			mPendingView = view;
+		}
+		mCondition.notify_one();
+	}
+
+	void RenderThread::screenshot()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mPendingScreenshot = true;
+		}
+		mCondition.notify_one();
+	}
+
+	void RenderThread::toggleRecording()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mPendingRecordToggle = !mPendingRecordToggle;
+		}
+		mCondition.notify_one();
+	}
+
+	/// @brief Report render thread failures on the polling thread
+	/// @return false once the window should close
+	bool RenderThread::poll()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if (mError) {
+				std::rethrow_exception(mError);
+			}
+		}
+		if (glfwWindowShouldClose(static_cast<GLFWwindow*>(mContext->window()))) {
+			return false;
+		}
+		return true;
+	}
+
+	void RenderThread::run()
+	{
+		Profiler::SetThreadName("render");
+		GLFWwindow* window = static_cast<GLFWwindow*>(mContext->window());
+		glfwMakeContextCurrent(window);
+		// Whatever the state cache of this thread knew belongs to another context
+		GetGLState().invalidate();
+		ApplyPresentMode(mPresent.mode);
+
+		try {
+			// GL objects are created and destroyed on this thread only
+			GLFWRenderer renderer(mContext, mAssets, mSize, mRender);
+			// Reads the finished frame before it is presented, the back buffer holds all of it whatever the damage
+			FrameRecorder recorder(mCaptureDir, mRecordRate);
+			renderer.setFrameCallback([&recorder](int width, int height) { recorder.readFrame(width, height); });
+			std::optional<FramePacer> pacer;
+			if (mPresent.mode == PresentMode::LIMITED) {
+				pacer.emplace(mPresent.frameLimit);
+			}
+			PresentStats stats(mScanOutMs);
+			GameSnapshot snapshot;
+			bool presented = false;
+			while (true) {
+				bool backToBack;
+				bool idle = false;
+				{
+					std::unique_lock<std::mutex> lock(mMutex);
+					// Moving cells need frames until they come to rest, new snapshots or not
+					bool animating = renderer.animating();
+					// So does a recording, or a screenshot until its frame is drawn
+					bool capturing = recorder.wantsFrame();
+					backToBack = presented && (mPendingSnapshot || mPendingSize || mPendingView || animating || capturing);
+					auto ready = [this, animating, capturing] {
+						return mStopping || mPendingSnapshot || mPendingSize || mPendingView || mPendingScreenshot || mPendingRecordToggle
+							|| animating || capturing;
+					};
+					if (recorder.busy()) {
+						idle = !mCondition.wait_for(lock, captureCollectInterval, ready);
+					} else {
+						mCondition.wait(lock, ready);
+					}
+					if (mStopping) {
+						break;
+					}
+				}
+				if (idle) {
+					// No frame came to push the last reads out of the ring
+					recorder.collect(true);
+					continue;
+				}
+				if (pacer) {
+					// Input arriving while the pacer waits still makes it into this frame
+					PROFILE_ZONE("pace");
+					pacer->wait();
+				}
+
+				std::optional<FrameTime> input;
+				std::optional<SurfaceSize> size;
+				std::optional<CameraView> view;
+				bool screenshot;
+				bool recordToggle;
+				{
+					std::lock_guard<std::mutex> lock(mMutex);
+					if (mStopping) {
+						break;
+					}
+					// A resize or camera move alone draws the last snapshot again
+					if (mPendingSnapshot) {
+						snapshot = *mPendingSnapshot;
+					}
+					// Animation & capture frames take no new input, the input time of an earlier frame would count towards their latency
+					if (mPendingSnapshot || mPendingSize || mPendingView) {
+						input = mPendingInput;
+					}
+					size = mPendingSize;
+					view = mPendingView;
+					screenshot = mPendingScreenshot;
+					recordToggle = mPendingRecordToggle;
+					mPendingSnapshot.reset();
+					mPendingSize.reset();
+					mPendingView.reset();
+					mPendingScreenshot = false;
+					mPendingRecordToggle = false;
+				}
+				if (size) {
+					renderer.resize(*size);
+				}
+				if (view) {
+					renderer.setView(*view);
+				}
+				if (screenshot) {
+					recorder.requestScreenshot();
+				}
+				if (recordToggle) {
+					recorder.toggleRecording();
+				}
+				if (recorder.wantsFrame()) {
+					renderer.redraw();
+				}
+				presented = renderer.render(snapshot);
+				recorder.collect(false);
+				if (presented && mPresent.measure) {
+					stats.presented(input, backToBack);
+				}
+			}
+			if (mPresent.measure) {
+				stats.print();
+			}
+			if (mRender.glStats) {
+				renderer.printGLStats();
+			}
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(mMutex);
+			mError = std::current_exception();
+		}
+
+		glfwMakeContextCurrent(nullptr);
+	}
+}
@@ -1,350 +1,331 @@
-#include <renderer.hpp>
-#include <exception.hpp>
-
-#include <memory>
-#include <optional>
-#include <cassert>
-#include <array>
-
-#include <glad/gl.h>
-#define GLFW_INCLUDE_NONE
-#include <GLFW/glfw3.h>
-
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-
-#include <ft2build.h>
-#include FT_FREETYPE_H
-
-namespace opengles_workspace
-{
-	float scoreX = -0.9f;
-	float scoreY = 1.0f;
-	float boardX = -0.9f;
-	float boardY = 0.8f;
-	float boardSquareSize = 0.2f;
-
-	float ItoYcoord(int I)
-	{
-		return boardY-(boardSquareSize*I);
-	}
-
-	float JtoXcoord(int J)
-	{
-		return boardX+(boardSquareSize*J);
-	}
-
-	void LoadTexture(const char* path)
-	{
-		// Create texture
-		unsigned int texture;
-		glGenTextures(1, &texture);
-		glBindTexture(GL_TEXTURE_2D, texture);
-
-		// Set the texture wrapping/filtering options (on currently bound texture)
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-		// Load and generate the texture
-		int width, height, nrChannels;
-		unsigned char *data = stbi_load(path, &width, &height,
-		&nrChannels, 0);
-		if (data)
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB,
-			GL_UNSIGNED_BYTE, data);
-			glGenerateMipmap(GL_TEXTURE_2D);
-		}
-		else
-		{
-			printf("Failed to load texture at [%s]\n", path);
-		}
-	}
-
-	FT_Face face;
-	void InitFT()
-	{
-		// Init FreeType
-		FT_Library ft;
-		if(FT_Init_FreeType(&ft))
-		{
-			fprintf(stderr, "Could not init freetype library\n");
-		}
-		// Load font as FT_Face
-		if(FT_New_Face(ft, "../font/font.ttf", 0, &face))
-		{
-			fprintf(stderr, "Could not open font\n");
-		}
-		// Set font size
-		FT_Set_Pixel_Sizes(face, 0, 48);
-	}
-
-	void DrawGameText(float x, float y, FT_Bitmap bitmap)
-	{
-		// Get bitmap data and dimensions
-		unsigned char* bitmapCharData = bitmap.buffer;
-		float bitmapWidth = (float)bitmap.width/200.0f;
-		float bitmapHeight = (float)bitmap.rows/200.0f;
-
-		// Set center offsets to correctly draw the character in the center of designated coordinates
-		float centerOffsetX = (boardSquareSize - bitmapWidth)/2.0f;
-		float leftX = x + centerOffsetX;
-		float rightX = leftX + bitmapWidth;
-
-		float centerOffsetY = (boardSquareSize - bitmapHeight)/2.0f;
-		float topY = y - centerOffsetY;
-		float bottomY = topY - bitmapHeight;
-
-		// Character square vertices
-		GLfloat vVertices[] = 	{
-								 leftX,		topY,		0.0f,	// Top left
-								 rightX,	topY,		0.0f,	// Top right
-								 rightX,	bottomY,	0.0f,	// Bottom right
-								 leftX,		bottomY,	0.0f	// Bottom left
-								};
-		// Load the vertex data
-		glVertexAttribPointer ( 0, 3, GL_FLOAT, GL_FALSE, 0, vVertices );
-		glEnableVertexAttribArray ( 0 );
-
-		// Texture coordinates
-		GLfloat texCoord[] = 	{
-								 0.0f, 0.0f,		// Bottom left
-								 1.0f, 0.0f,		// Bottom right
-								 1.0f, 1.0f,		// Top right
-								 0.0f, 1.0f,		// Top left
-								};
-		// Load the texture data
-		glVertexAttribPointer ( 2, 2, GL_FLOAT, GL_FALSE, 0, texCoord );
-		glEnableVertexAttribArray ( 2 );
-
-		unsigned int texture;
-		glGenTextures(1, &texture);
-		glBindTexture(GL_TEXTURE_2D, texture);
-
-		// Set the texture wrapping/filtering options (on currently bound texture)
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		// Load and generate the texture
-		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, bitmap.width, bitmap.rows, 0, GL_RED, GL_UNSIGNED_BYTE, bitmap.buffer);
-		glGenerateMipmap(GL_TEXTURE_2D);
-
-		glDrawArrays ( GL_QUADS, 0, 4 );
-	}
-
-	void DrawGameScore(float x, float y)
-	{
-		int score = GameLogic::GetScore();
-		std::string scoreString = "SCORE-" + std::to_string(score);
-
-		float X = x;
-		float Y = y;
-		for(char charToRender : scoreString)
-		{
-			// Load glyph of character
-			if(FT_Load_Char(face, charToRender, FT_LOAD_RENDER))
-			{
-				fprintf(stderr, "Could not load character '%d'\n", charToRender);
-			}
-			FT_Bitmap bitmap = face->glyph->bitmap;			
-
-			DrawGameText(X, Y, bitmap);
-			X += boardSquareSize;
-		}
-	}
-
-	void DrawGameShape(float x, float y, const char* texturePath)
-	{
-		// Set correct coordinates
-		float leftX = x;
-		float rightX = leftX + boardSquareSize;
-
-		float topY = y;
-		float bottomY = topY - boardSquareSize;
-
-		// Shape square vertices
-		GLfloat vVertices[] = 	{
-								 leftX,		topY,		0.0f,	// Top left
-								 rightX,	topY,		0.0f,	// Top right
-								 rightX,	bottomY,	0.0f,	// Bottom right
-								 leftX,		bottomY,	0.0f	// Bottom left
-								};
-		// Load the vertex data
-		glVertexAttribPointer ( 0, 3, GL_FLOAT, GL_FALSE, 0, vVertices );
-		glEnableVertexAttribArray ( 0 );
-
-		// Texture coordinates
-		GLfloat texCoord[] = 	{
-								 0.0f, 0.0f,		// Bottom left
-								 1.0f, 0.0f,		// Bottom right
-								 1.0f, 1.0f,		// Top right
-								 0.0f, 1.0f,		// Top left
-								};
-		// Load the texture data
-		glVertexAttribPointer ( 2, 2, GL_FLOAT, GL_FALSE, 0, texCoord );
-		glEnableVertexAttribArray ( 2 );
-
-		LoadTexture(texturePath);
-
-		glDrawArrays ( GL_QUADS, 0, 4 );
-	}
-
-	void DrawGameBoard(float x, float y)
-	{
-		float X = x;
-		float Y = y;
-
-		for(int rows = 0; rows < GameLogic::gameBoardSize; rows++)
-		{
-			// Reset X coordinate every row
-			X = x;
-			for(int columns = 0; columns < GameLogic::gameBoardSize; columns++)
-			{
-				// Get texture path of shape at specific row & column
-				std::string texturePathStr = GameLogic::GetShapeAt(rows,columns).GetTexturePath();
-				const char* texturePath = texturePathStr.c_str();
-
-				DrawGameShape(X, Y, texturePath);
-				// Increase X coordinate after every collumn finished rendering
-				X += boardSquareSize;
-			}
-			// Decrease Y coordinate after row finished rendering
-			Y -= boardSquareSize;
-		}
-	}
-	
-	char vShaderStr[] =
-		"#version 300 es \n"
-		"\n"
-		"layout(location = 0) in vec4 a_position; \n"
-		"layout(location = 2) in vec2 a_textures; \n"
-		"out vec2 v_textures; \n"
-		"\n"
-		"void main() \n"
-		"{ \n"
-		" gl_Position = a_position; \n"
-		" v_textures = a_textures; \n"
-		"} \n";
-	
-	char fShaderStr[] =
-		"#version 300 es \n"
-		"precision mediump float; \n"
-		"\n"
-		"in vec2 v_textures; \n"
-		"out vec4 fragColor; \n"
-		"uniform sampler2D ourTexture; \n"
-		"\n"
-		"void main() \n"
-		"{ \n"
-		" fragColor =  texture(ourTexture, v_textures); \n"
-		"} \n";
-
-	GLFWRenderer::GLFWRenderer(std::shared_ptr<Context> context)
-		: mContext(std::move(context))
-	{
-		// Prepare vertex shader
-		const char * tmpShader = vShaderStr;
-		GLuint vertexShader = glCreateShader( GL_VERTEX_SHADER );
-		glShaderSource(vertexShader, 1, &tmpShader, NULL);
-		glCompileShader(vertexShader);
-		
-		// Prepare fragment shader
-		tmpShader = fShaderStr;
-		GLuint fragmentShader = glCreateShader( GL_FRAGMENT_SHADER );
-		glShaderSource(fragmentShader, 1, &tmpShader, NULL);
-		glCompileShader(fragmentShader);
-
-		// Create the program object
-		GLuint programObject = glCreateProgram();
-		glAttachShader ( programObject, vertexShader );
-		glAttachShader ( programObject, fragmentShader );
-
-		// Link the program
-		glLinkProgram ( programObject );
-
-		// Use the program object
-		glUseProgram ( programObject );
-
-		// Set the viewport
-		GLint windowWidth, windowHeight;
-    	glfwGetWindowSize(window(), &windowWidth, &windowHeight);
-		glViewport ( 0, 0, windowWidth, windowHeight );
-
-		// Init FreeType
-		InitFT();
-	}
-
-	void GLFWRenderer::render() {
-		// GL code begin
-
-		// Clear the color buffer
-		glClear ( GL_COLOR_BUFFER_BIT );
-
-		DrawGameBoard(boardX, boardY);
-		DrawGameScore(scoreX, scoreY);
-
-		// GL code end
-		glfwSwapBuffers(window());
-	}
-
-	void GLFWRenderer::renderOnlyCursor(Direction direction)
-	{
-		// Get indexes of current shape
-		int i = GameLogic::GetCurrentI();
-		int j = GameLogic::GetCurrentJ();
-
-		// Convert indexes to coordinates
-		float x = JtoXcoord(j);
-		float y = ItoYcoord(i);
-
-		// Get texture path of current shape
-		std::string texturePathStr = GameLogic::GetShapeAt(i,j).GetTexturePath();
-		const char* texturePath = texturePathStr.c_str();
-
-		// Redraw only current shape
-		DrawGameShape(x, y, texturePath);
-
-		switch (direction)
-		{
-		case UP:
-			i++;
-			break;
-		case LEFT:
-			j++;
-			break;
-		case DOWN:
-			i--;
-			break;
-		case RIGHT:
-			j--;
-			break;
-		default:
-			break;
-		}
-
-		// Convert indexes to coordinates
-		x = JtoXcoord(j);
-		y = ItoYcoord(i);
-
-		// Get texture path of current shape
-		texturePathStr = GameLogic::GetShapeAt(i,j).GetTexturePath();
-		texturePath = texturePathStr.c_str();
-
-		// Redraw only current shape
-		DrawGameShape(x, y, texturePath);
-
-		glfwSwapBuffers(window());
-	}
-
-	bool GLFWRenderer::poll() {
-		if (glfwWindowShouldClose(window())) {
-			return false;
-		}
-		return true;
-	}
+#include <renderer.hpp>
+#include <exception.hpp>
+#include <shader.hpp>
+#include <profiler.hpp>
+#include <gl_state_cache.hpp>
+
+#include <memory>
+#include <optional>
+#include <cassert>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <cstdio>
+
+#include <glad/gl.h>
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+namespace opengles_workspace
+{
+	const int maxHudLabels = 4;
+	// Frames the GPU may still be drawing while the next one streams its quads
+	const int spriteRegions = 3;
+	// Animation times restart from zero once idle for this long, float seconds lose precision further out
+	const float timeRebaseSeconds = 600.0f;
+	// Oldest back buffer whose contents are still patched up instead of repainted
+	const int maxBufferAge = 4;
+	const size_t frameArenaSize = 64 * 1024;
+	const size_t maxFrameCommands = 256;
+	const size_t boardArenaSize = 1024;
+	const size_t maxBoardCommands = 4;
+
+	char vShaderStr[] =
+		"#version 300 es \n"
+		"\n"
+		"layout(location = 0) in vec4 a_position; \n"
+		"layout(location = 2) in vec2 a_textures; \n"
+		"out vec2 v_textures; \n"
+		"\n"
+		"void main() \n"
+		"{ \n"
+		" gl_Position = a_position; \n"
+		" v_textures = a_textures; \n"
+		"} \n";
+	
+	char fShaderStr[] =
+		"#version 300 es \n"
+		"precision mediump float; \n"
+		"\n"
+		"in vec2 v_textures; \n"
+		"out vec4 fragColor; \n"
+		"uniform sampler2D ourTexture; \n"
+		"\n"
+		"void main() \n"
+		"{ \n"
+		// The outline sits at 0.5 in the distance field, smoothed over about one framebuffer pixel at any text size
+		" float distance = texture(ourTexture, v_textures).r; \n"
+		" float edge = max(fwidth(distance) * 0.5, 0.001); \n"
+		" float coverage = smoothstep(0.5 - edge, 0.5 + edge, distance); \n"
+		// Padded glyph quads overlap their neighbours, only pixels of the glyph itself are written
+		" if(coverage <= 0.0) \n"
+		"  discard; \n"
+		" fragColor = vec4(coverage, 0.0, 0.0, 1.0); \n"
+		"} \n";
+
+	GLFWRenderer::GLFWRenderer(std::shared_ptr<Context> context, std::shared_ptr<AssetLoader> assets, const SurfaceSize& size, const RenderOptions& options)
+		: mContext(std::move(context))
+		, mAssets(std::move(assets))
+		, mBoard(mShaders, *mAssets)
+		, mGlyphs(mAssets->font())
+		, mSprites(maxHudLabels * Layout::maxHudLabelLength, spriteRegions)
+		, mHud(mGlyphs, mSprites, maxHudLabels, Layout::maxHudLabelLength)
+		, mShownScore(-1)
+		, mDamage(maxBufferAge)
+		, mPresenter(window())
+		, mCommands(frameArenaSize, maxFrameCommands)
+		, mBoardCommands(boardArenaSize, maxBoardCommands)
+		, mFrameTime(0.0f)
+		, mGLFrames(0)
+	{
+		setClock([] { return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count(); });
+
+		// Prepare the text program, the board has its own
+		mTextProgram = mShaders.createProgram(vShaderStr, fShaderStr);
+		if(options.tileMap)
+		{
+			mTileMap.reset(new TileMapRenderer(mShaders, mBoard.shapeMasks(), mAssets->palette(), GameLogic::gameBoardSize, GameLogic::gameBoardSize));
+		}
+		if(options.boardCache)
+		{
+			mBoardLayer.reset(new BoardLayerCache(mShaders));
+		}
+
+		// Placed by the layout
+		mScoreLabel = mHud.addLabel(0.0f, 0.0f, 0.0f, 0.0f);
+		resize(size);
+	}
+
+	/// @brief Recompute the layout & rebuild only the geometry that depends on it
+	/// @param size framebuffer size in pixels & content scale
+	void GLFWRenderer::resize(const SurfaceSize& size)
+	{
+		if(!mLayout.resize(size))
+		{
+			return;
+		}
+
+		// The viewport covers the framebuffer, which is larger than the window on HiDPI screens
+		GetGLState().viewport(0, 0, size.width, size.height);
+
+		// Distance field glyphs scale to any size without rasterising again, the board picks up its cells on the next update
+		mHud.moveLabel(mScoreLabel, mLayout.scoreX(), mLayout.scoreY(), mLayout.cellWidth(), mLayout.cellHeight());
+		mHud.setGlyphScale(mLayout.glyphScaleX(GlyphAtlas::pixelSize), mLayout.glyphScaleY(GlyphAtlas::pixelSize));
+
+		// Neither the new size nor the first frame has previous contents to build on
+		mDamage.resize(size.width, size.height);
+		if(mBoardLayer)
+		{
+			mBoardLayer->setBounds(NdcToPixelRect(mLayout.boardLeft(), mLayout.boardTop(), mLayout.boardRight(), mLayout.boardBottom()),
+				size.width, size.height);
+		}
+	}
+
+	/// @brief Look at another part of the board, the board area is drawn again on the next frame
+	/// @param view zoom & center of the camera
+	void GLFWRenderer::setView(const CameraView& view)
+	{
+		if(mLayout.setView(view))
+		{
+			addBoardDamage(mLayout.boardLeft(), mLayout.boardTop(), mLayout.boardRight(), mLayout.boardBottom());
+		}
+	}
+
+	bool GLFWRenderer::render(const GameSnapshot& snapshot) {
+		PROFILE_ZONE("render");
+		mGpuProfiler.collect();
+
+		// One time value drives every cell animation, the instances only change when a motion starts
+		double now = mClock();
+		mFrameTime = (float)(now - mTimeBase);
+		if(mFrameTime > timeRebaseSeconds && !mTileMap && !mBoard.animating(mFrameTime))
+		{
+			mBoard.rebaseTime(mFrameTime);
+			mTimeBase = now;
+			mFrameTime = 0.0f;
+		}
+
+		// Collect what changed since the last frame
+		if(mTileMap)
+		{
+			PROFILE_ZONE("update board");
+			mTileMap->update(snapshot, mLayout);
+			if(mTileMap->allChanged())
+			{
+				addBoardDamage(mLayout.boardLeft(), mLayout.boardTop(), mLayout.boardRight(), mLayout.boardBottom());
+			}
+			for(int cell : mTileMap->changedCells())
+			{
+				float leftX = mLayout.cellX(cell % GameLogic::gameBoardSize);
+				float topY = mLayout.cellY(cell / GameLogic::gameBoardSize);
+				addBoardDamage(leftX, topY, leftX + mLayout.tileWidth(), topY - mLayout.tileHeight());
+			}
+		}
+		else
+		{
+			PROFILE_ZONE("update board");
+			mBoard.update(snapshot, mLayout, mFrameTime);
+			for(int cell : mBoard.changedCells())
+			{
+				float leftX, topY, rightX, bottomY;
+				mBoard.cellBounds(cell, leftX, topY, rightX, bottomY);
+				addBoardDamage(leftX, topY, rightX, bottomY);
+			}
+		}
+
+		// The score text is only laid out again when the score changed
+		int score = snapshot.score;
+		if(score != mShownScore)
+		{
+			PROFILE_ZONE("update score");
+			mHud.setText(mScoreLabel, "SCORE-" + std::to_string(score));
+			mShownScore = score;
+			float scoreX = mLayout.scoreX();
+			float scoreY = mLayout.scoreY();
+			mDamage.addRect(NdcToPixelRect(scoreX, scoreY, scoreX + mLayout.cellWidth() * Layout::maxHudLabelLength, scoreY - mLayout.cellHeight()));
+		}
+
+		// Nothing changed, keep presenting the previous frame
+		if(mDamage.empty())
+		{
+			return false;
+		}
+
+		// Moving cells are drawn directly, the layer catches up with them once they come to rest
+		bool boardLayer = mBoardLayer && (mTileMap || !mBoard.animating(mFrameTime));
+
+		// Record the frame once, every damaged rectangle replays it
+		{
+			PROFILE_ZONE("record commands");
+			mCommands.reset();
+			if(boardLayer)
+			{
+				mBoardLayer->record(mCommands);
+			}
+			else
+			{
+				recordBoard(mCommands);
+			}
+			mHud.record(mCommands, mTextProgram);
+			mCommands.sort();
+		}
+
+		// GL code begin
+
+		// Bring the changed cells of the board layer up to date, a frame without board changes skips the board entirely
+		if(boardLayer && mBoardLayer->stale())
+		{
+			PROFILE_ZONE("board layer");
+			GpuProfileZone gpuZone(mGpuProfiler, "board layer");
+			mBoardCommands.reset();
+			recordBoard(mBoardCommands);
+			mBoardCommands.sort();
+			mBoardLayer->refresh(mBackend, mBoardCommands);
+		}
+
+		// Repaint only the damaged rectangles, plus whatever the back buffer missed while it was in flight
+		{
+			PROFILE_ZONE("submit");
+			GpuProfileZone gpuZone(mGpuProfiler, "draw");
+			GLStateCache& state = GetGLState();
+			state.setEnabled(GL_SCISSOR_TEST, true);
+			for(const DamageRect& rect : mDamage.repaintRegion(mPresenter.bufferAge()))
+			{
+				state.scissor(rect.x, rect.y, rect.width, rect.height);
+
+				// Clear the color buffer
+				glClear ( GL_COLOR_BUFFER_BIT );
+
+				mBackend.submit(mCommands);
+			}
+			state.setEnabled(GL_SCISSOR_TEST, false);
+
+			// Every damaged rectangle draws from the same sprite regions, one fence covers them all
+			mSprites.fence();
+		}
+
+		// GL code end
+		// State calls of the frame, together with those of a resize or camera move before it
+		GLStateCache& state = GetGLState();
+		mGLTotals.issued += state.counters().issued;
+		mGLTotals.skipped += state.counters().skipped;
+		mGLFrames++;
+		state.resetCounters();
+
+		if(mFrameCallback)
+		{
+			mFrameCallback(mLayout.surface().width, mLayout.surface().height);
+		}
+		PROFILE_ZONE("present");
+		mPresenter.present(mDamage.frameDamage());
+		mDamage.endFrame();
+		return true;
+	}
+
+	/// @brief Convert a rectangle from normalized device coordinates to framebuffer pixels, rounding outwards
+	/// @return Pixel rectangle covering the NDC rectangle
+	DamageRect GLFWRenderer::NdcToPixelRect(float leftX, float topY, float rightX, float bottomY) const
+	{
+		int left = (int)std::floor((leftX + 1.0f) * 0.5f * mLayout.surface().width);
+		int right = (int)std::ceil((rightX + 1.0f) * 0.5f * mLayout.surface().width);
+		int bottom = (int)std::floor((bottomY + 1.0f) * 0.5f * mLayout.surface().height);
+		int top = (int)std::ceil((topY + 1.0f) * 0.5f * mLayout.surface().height);
+		return { left, bottom, right - left, top - bottom };
+	}
+
+	/// @brief Damage the part of a rectangle inside the board area, nothing of the board is drawn outside it
+	void GLFWRenderer::addBoardDamage(float leftX, float topY, float rightX, float bottomY)
+	{
+		leftX = std::max(leftX, mLayout.boardLeft());
+		topY = std::min(topY, mLayout.boardTop());
+		rightX = std::min(rightX, mLayout.boardRight());
+		bottomY = std::max(bottomY, mLayout.boardBottom());
+		if(rightX > leftX && topY > bottomY)
+		{
+			DamageRect rect = NdcToPixelRect(leftX, topY, rightX, bottomY);
+			mDamage.addRect(rect);
+			if(mBoardLayer)
+			{
+				mBoardLayer->invalidate(rect);
+			}
+		}
+	}
+
+	/// @brief Record the board draw of whichever renderer draws it
+	/// @param commands frame or board layer commands
+	void GLFWRenderer::recordBoard(RenderCommandBuffer& commands)
+	{
+		if(mTileMap)
+		{
+			mTileMap->record(commands);
+		}
+		else
+		{
+			mBoard.record(commands, mFrameTime);
+		}
+	}
+
+	/// @brief Print the state calls per presented frame & the share the state cache kept from the driver
+	void GLFWRenderer::printGLStats() const
+	{
+		uint64_t total = mGLTotals.issued + mGLTotals.skipped;
+		if(mGLFrames == 0 || total == 0)
+		{
+			printf("GL state calls: no frames\n");
+			return;
+		}
+		printf("GL state calls: %d frames, %.1f issued & %.1f skipped per frame, %.0f%% saved\n", mGLFrames,
+			(double)mGLTotals.issued / mGLFrames, (double)mGLTotals.skipped / mGLFrames, 100.0 * mGLTotals.skipped / total);
+	}
+
+	bool GLFWRenderer::poll() {
+		if (glfwWindowShouldClose(window())) {
+			return false;
+		}
+		return true;
+	}
 }
\ No newline at end of file
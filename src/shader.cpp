@@ -0,0 +1,257 @@
+#include <shader.hpp>
+#include <gl_extensions.hpp>
+#include <gl_state_cache.hpp>
+#include <exception.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+namespace opengles_workspace
+{
+	// Written before every cached binary, bump it to invalidate old cache files
+	const uint32_t programCacheMagic = 0x53535031;
+
+	/// @brief 64-bit FNV-1a hash
+	/// @param data text to hash
+	/// @param hash hash to continue from
+	/// @return Updated hash
+	static uint64_t HashString(const std::string& data, uint64_t hash = 14695981039346656037ull)
+	{
+		for(unsigned char character : data)
+		{
+			hash ^= character;
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	/// @brief Pick the per-user cache directory, following the XDG base directory spec
+	/// @return Directory for program binaries, empty if there is no home directory
+	static std::string ProgramCacheDirectory()
+	{
+		const char* cacheHome = getenv("XDG_CACHE_HOME");
+		if(cacheHome && cacheHome[0] != '\0')
+		{
+			return std::string(cacheHome) + "/shapeshifter/programs";
+		}
+		const char* home = getenv("HOME");
+		if(home && home[0] != '\0')
+		{
+			return std::string(home) + "/.cache/shapeshifter/programs";
+		}
+		return "";
+	}
+
+	/// @brief Compile one shader stage
+	/// @param type GL_VERTEX_SHADER or GL_FRAGMENT_SHADER
+	/// @param source shader source
+	/// @return Compiled shader object, throws Exception with the info log on failure
+	static GLuint CompileShader(GLenum type, const char* source)
+	{
+		GLuint shader = glCreateShader(type);
+		glShaderSource(shader, 1, &source, NULL);
+		glCompileShader(shader);
+
+		GLint compiled = GL_FALSE;
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+		if(!compiled)
+		{
+			GLint logLength = 0;
+			glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength);
+			std::string log(logLength > 0 ? logLength : 1, '\0');
+			glGetShaderInfoLog(shader, (GLsizei)log.size(), NULL, &log[0]);
+			glDeleteShader(shader);
+			throw Exception(std::string(type == GL_VERTEX_SHADER ? "Vertex" : "Fragment") + " shader failed to compile: " + log.c_str());
+		}
+		return shader;
+	}
+
+	/// @brief Get the info log of a program
+	/// @param program program object
+	/// @return Info log text
+	static std::string ProgramInfoLog(GLuint program)
+	{
+		GLint logLength = 0;
+		glGetProgramiv(program, GL_INFO_LOG_LENGTH, &logLength);
+		std::string log(logLength > 0 ? logLength : 1, '\0');
+		glGetProgramInfoLog(program, (GLsizei)log.size(), NULL, &log[0]);
+		return log.c_str();
+	}
+
+	ShaderManager::ShaderManager()
+	{
+		GLint formatCount = 0;
+		if(GetGLExtensions().programBinary)
+		{
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+		}
+		if(formatCount > 0)
+		{
+			mCacheDirectory = ProgramCacheDirectory();
+		}
+
+		const char* vendor = (const char*)glGetString(GL_VENDOR);
+		const char* renderer = (const char*)glGetString(GL_RENDERER);
+		const char* version = (const char*)glGetString(GL_VERSION);
+		mDriver = std::string(vendor ? vendor : "") + "\n" + (renderer ? renderer : "") + "\n" + (version ? version : "");
+	}
+
+	ShaderManager::~ShaderManager()
+	{
+		for(GLuint program : mPrograms)
+		{
+			GetGLState().deleteProgram(program);
+		}
+	}
+
+	/// @brief Create a program, from the binary cache if the same driver linked the same sources before
+	/// @param vertexSource vertex shader source
+	/// @param fragmentSource fragment shader source
+	/// @return Linked program object, owned by the manager
+	GLuint ShaderManager::createProgram(const char* vertexSource, const char* fragmentSource)
+	{
+		std::string cachePath;
+		if(!mCacheDirectory.empty())
+		{
+			uint64_t key = HashString(fragmentSource, HashString(std::string(vertexSource) + '\0', HashString(mDriver + '\0')));
+			char name[32];
+			snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+			cachePath = mCacheDirectory + "/" + name;
+
+			GLuint cached = loadCachedProgram(cachePath);
+			if(cached)
+			{
+				mPrograms.push_back(cached);
+				return cached;
+			}
+		}
+
+		// Prepare the shaders
+		GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, vertexSource);
+		GLuint fragmentShader;
+		try
+		{
+			fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentSource);
+		}
+		catch(...)
+		{
+			glDeleteShader(vertexShader);
+			throw;
+		}
+
+		// Create the program object
+		GLuint programObject = glCreateProgram();
+		glAttachShader ( programObject, vertexShader );
+		glAttachShader ( programObject, fragmentShader );
+		if(!cachePath.empty())
+		{
+			GetGLExtensions().ProgramParameteri(programObject, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
+
+		// Link the program, the shader objects are no longer needed afterwards
+		glLinkProgram ( programObject );
+		glDetachShader ( programObject, vertexShader );
+		glDetachShader ( programObject, fragmentShader );
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+
+		GLint linked = GL_FALSE;
+		glGetProgramiv(programObject, GL_LINK_STATUS, &linked);
+		if(!linked)
+		{
+			std::string log = ProgramInfoLog(programObject);
+			GetGLState().deleteProgram(programObject);
+			throw Exception("Program failed to link: " + log);
+		}
+
+		if(!cachePath.empty())
+		{
+			storeCachedProgram(cachePath, programObject);
+		}
+		mPrograms.push_back(programObject);
+		return programObject;
+	}
+
+	/// @brief Load a cached program binary
+	/// @param path cache file
+	/// @return Linked program object, 0 if there is no usable binary
+	GLuint ShaderManager::loadCachedProgram(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if(!file)
+		{
+			return 0;
+		}
+		uint32_t header[2] = { 0, 0 };
+		if(!file.read(reinterpret_cast<char*>(header), sizeof(header)) || header[0] != programCacheMagic)
+		{
+			return 0;
+		}
+		std::vector<char> binary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		if(binary.empty())
+		{
+			return 0;
+		}
+
+		// The driver may still reject the binary, e.g. after an update that kept the version string
+		GLuint program = glCreateProgram();
+		GetGLExtensions().ProgramBinary(program, header[1], binary.data(), (GLsizei)binary.size());
+		GLint linked = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &linked);
+		if(!linked)
+		{
+			GetGLState().deleteProgram(program);
+			return 0;
+		}
+		return program;
+	}
+
+	/// @brief Store the binary of a linked program, failures only cost the next launch a compile
+	/// @param path cache file
+	/// @param program linked program object
+	void ShaderManager::storeCachedProgram(const std::string& path, GLuint program)
+	{
+		GLint length = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+		if(length <= 0)
+		{
+			return;
+		}
+		std::vector<char> binary(length);
+		GLenum format = 0;
+		GetGLExtensions().GetProgramBinary(program, length, &length, &format, binary.data());
+
+		std::error_code error;
+		std::filesystem::create_directories(mCacheDirectory, error);
+
+		// Write to a temporary file first so a concurrent launch never reads half a binary
+		// Its name is unique to this launch, two launches storing the same program would otherwise write into one file
+		std::string temporaryPath = path + "." + std::to_string(std::random_device()()) + ".tmp";
+		bool written;
+		{
+			std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+			uint32_t header[2] = { programCacheMagic, format };
+			file.write(reinterpret_cast<const char*>(header), sizeof(header));
+			file.write(binary.data(), length);
+			file.close();
+			written = !file.fail();
+		}
+		if(!written)
+		{
+			fprintf(stderr, "Could not write program cache [%s]\n", temporaryPath.c_str());
+			std::filesystem::remove(temporaryPath, error);
+			return;
+		}
+		std::filesystem::rename(temporaryPath, path, error);
+		if(error)
+		{
+			std::filesystem::remove(temporaryPath, error);
+		}
+	}
+}
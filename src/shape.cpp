@@ -13,6 +13,13 @@ namespace opengles_workspace
         shapeStatus = NONE;
     }
 
+    /// @brief Seed the random colour generator, for reproducible boards
+    /// @param seed generator seed
+    void Shape::SeedRandom(unsigned int seed)
+    {
+        gen.seed(seed);
+    }
+
     /// @brief Set colour to Shape
     /// @param colour colour you want to set (RED, GREEN, BLUE)
     void Shape::SetColour(ShapeColour colour)
@@ -88,57 +95,80 @@ namespace opengles_workspace
         return returnedString;
     }
 
-    /// @brief Get texture path of Shape as string
-    /// @return Texture path
-    std::string Shape::GetTexturePath()
+    /// @brief Get the lower case name of a colour, used by the shape masks & the palette
+    /// @param colour shape colour
+    /// @return Colour name, "base" for the empty cell
+    std::string Shape::GetColourName(ShapeColour colour)
     {
         std::string returnedString = "";
-        switch (this->shapeColour)
+        switch (colour)
         {
         case RED:
-            returnedString = "../images/red";
+            returnedString = "red";
             break;
         case GREEN:
-            returnedString = "../images/green";
+            returnedString = "green";
             break;
         case BLUE:
-            returnedString = "../images/blue";
+            returnedString = "blue";
             break;
         case CYAN:
-            returnedString = "../images/cyan";
+            returnedString = "cyan";
             break;
         case MAGENTA:
-            returnedString = "../images/magenta";
+            returnedString = "magenta";
             break;
         case YELLOW:
-            returnedString = "../images/yellow";
+            returnedString = "yellow";
             break;
         case LIME:
-            returnedString = "../images/lime";
+            returnedString = "lime";
             break;
         case BEIGE:
-            returnedString = "../images/beige";
+            returnedString = "beige";
             break;
         case PINK:
-            returnedString = "../images/pink";
+            returnedString = "pink";
             break;
         default:
-            returnedString = "../images/base";
+            returnedString = "base";
             break;
         }
+        return returnedString;
+    }
 
-        switch (this->shapeStatus)
+    /// @brief Get the lower case name of a status, used by the frame masks & the palette
+    /// @param status shape status
+    /// @return Status name
+    std::string Shape::GetStatusName(ShapeStatus status)
+    {
+        switch (status)
         {
         case SELECTABLE:
-            returnedString = returnedString + "_selectable";
-            break;
+            return "selectable";
         case SELECTED:
-            returnedString = returnedString + "_selected";
-            break;
+            return "selected";
         default:
-            break;
+            return "none";
+        }
+    }
+
+    /// @brief Get the name of a mask layer, shared by the source image & its baked texture
+    /// @param maskLayer shape mask of a colour below colourCount, frame mask of a status after them
+    /// @return Mask name without directory or extension, e.g. "shape_red" or "frame_selected"
+    std::string Shape::GetMaskName(int maskLayer)
+    {
+        if (maskLayer < colourCount)
+        {
+            return "shape_" + GetColourName(ShapeColour(maskLayer));
         }
+        return "frame_" + GetStatusName(ShapeStatus(maskLayer - colourCount));
+    }
 
-        return returnedString + ".jpg";
+    /// @brief Get the colour & status pair of Shape, picking its shape mask, frame mask & palette entries
+    /// @return Pair index (colour * 3 + status)
+    int Shape::GetTextureLayer()
+    {
+        return this->shapeColour * (SELECTED + 1) + this->shapeStatus;
     }
 }
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include <shape_palette.hpp>
+#include <exception.hpp>
+#include <gl_state_cache.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+namespace opengles_workspace
+{
+	/// @brief Parse a colour written as six hex digits, e.g. ff812c
+	/// @param text colour text
+	/// @param colour receives the colour
+	/// @return false if the text is not a colour
+	static bool ParsePaletteColour(const std::string& text, PaletteColour& colour)
+	{
+		if(text.size() != 6 || text.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos)
+		{
+			return false;
+		}
+		unsigned long value = strtoul(text.c_str(), nullptr, 16);
+		colour = { (unsigned char)(value >> 16), (unsigned char)(value >> 8), (unsigned char)value };
+		return true;
+	}
+
+	/// @brief Colour a pixel with the formula of ColourCell in ShapePaletteShader
+	/// @param textureLayer colour & status pair, as reported by Shape::GetTextureLayer
+	/// @param shapeMask shape mask value
+	/// @param frameMask frame mask value
+	/// @return Pixel colour
+	PaletteColour ShapePalette::colour(int textureLayer, unsigned char shapeMask, unsigned char frameMask) const
+	{
+		int colourIndex = textureLayer / Shape::statusCount;
+		int status = textureLayer % Shape::statusCount;
+		float fill = std::min(std::max(shapeMask * (2.0f / 255.0f) - 1.0f, 0.0f), 1.0f);
+		float coverage = std::min(shapeMask * (2.0f / 255.0f), 1.0f);
+
+		PaletteColour pixel;
+		for(int channel = 0; channel < 3; channel++)
+		{
+			float outline = outlines[colourIndex][channel];
+			float ink = (outline + (fills[colourIndex][channel] - outline) * fill) * coverage;
+			pixel[channel] = (unsigned char)std::lround(ink + (frames[status][channel] - ink) * (frameMask / 255.0f));
+		}
+		return pixel;
+	}
+
+	/// @brief Parse a palette, one entry per line, blank lines & lines starting with # are skipped
+	/// "colour <name> <outline> <fill>" for every shape colour, "status <name> <frame>" for every status
+	/// @param text palette file contents
+	/// @param source file name for error messages
+	/// @return Palette with every entry set, throws Exception otherwise
+	ShapePalette ParseShapePalette(const std::string& text, const std::string& source)
+	{
+		ShapePalette palette;
+		std::vector<bool> colourSet(Shape::colourCount, false);
+		std::vector<bool> statusSet(Shape::statusCount, false);
+
+		std::istringstream lines(text);
+		std::string line;
+		for(int lineNumber = 1; std::getline(lines, line); lineNumber++)
+		{
+			std::istringstream words(line);
+			std::string kind, name, first, second, extra;
+			words >> kind >> name >> first >> second >> extra;
+			if(kind.empty() || kind[0] == '#')
+			{
+				continue;
+			}
+
+			std::string where = source + ":" + std::to_string(lineNumber) + ": ";
+			bool parsed = false;
+			if(kind == "colour" && extra.empty())
+			{
+				for(int colour = 0; colour < Shape::colourCount && !parsed; colour++)
+				{
+					if(name == Shape::GetColourName(ShapeColour(colour)))
+					{
+						parsed = ParsePaletteColour(first, palette.outlines[colour]) && ParsePaletteColour(second, palette.fills[colour]);
+						colourSet[colour] = parsed;
+					}
+				}
+			}
+			else if(kind == "status" && second.empty())
+			{
+				for(int status = 0; status < Shape::statusCount && !parsed; status++)
+				{
+					if(name == Shape::GetStatusName(ShapeStatus(status)))
+					{
+						parsed = ParsePaletteColour(first, palette.frames[status]);
+						statusSet[status] = parsed;
+					}
+				}
+			}
+			if(!parsed)
+			{
+				throw Exception(where + "expected \"colour <name> <outline> <fill>\" or \"status <name> <frame>\" with known names & rrggbb colours");
+			}
+		}
+
+		for(int colour = 0; colour < Shape::colourCount; colour++)
+		{
+			if(!colourSet[colour])
+			{
+				throw Exception(source + ": no colour " + Shape::GetColourName(ShapeColour(colour)));
+			}
+		}
+		for(int status = 0; status < Shape::statusCount; status++)
+		{
+			if(!statusSet[status])
+			{
+				throw Exception(source + ": no status " + Shape::GetStatusName(ShapeStatus(status)));
+			}
+		}
+		return palette;
+	}
+
+	/// @brief Build the palette part of a fragment shader, sized by the colour & status counts
+	/// @return GLSL source
+	std::string ShapePaletteShader()
+	{
+		std::string colours = std::to_string(Shape::colourCount);
+		std::string statuses = std::to_string(Shape::statusCount);
+		return
+			"uniform vec3 u_outlines[" + colours + "]; \n"
+			"uniform vec3 u_fills[" + colours + "]; \n"
+			"uniform vec3 u_frames[" + statuses + "]; \n"
+			"\n"
+			// Shape mask layer of the colour & frame mask layer of the status, from the pair index of a cell
+			"ivec2 CellMaskLayers(float pair) \n"
+			"{ \n"
+			" int index = int(pair + 0.5); \n"
+			" return ivec2(index / " + statuses + ", " + colours + " + index % " + statuses + "); \n"
+			"} \n"
+			"\n"
+			// The outline fades in over the first half of the shape mask & turns into the fill over the second, the frame goes on top
+			"vec4 ColourCell(float shape, float frame, float pair) \n"
+			"{ \n"
+			" int index = int(pair + 0.5); \n"
+			" int colour = index / " + statuses + "; \n"
+			" vec3 ink = mix(u_outlines[colour], u_fills[colour], clamp(shape * 2.0 - 1.0, 0.0, 1.0)) * min(shape * 2.0, 1.0); \n"
+			" return vec4(mix(ink, u_frames[index % " + statuses + "], frame), 1.0); \n"
+			"} \n";
+	}
+
+	/// @brief Upload the palette into a program built with ShapePaletteShader
+	/// @param program linked program
+	/// @param palette colours to upload
+	void SetShapePaletteUniforms(GLuint program, const ShapePalette& palette)
+	{
+		auto upload = [program](const char* name, const PaletteColour* colours, int count)
+		{
+			std::vector<GLfloat> values;
+			for(int index = 0; index < count; index++)
+			{
+				for(unsigned char channel : colours[index])
+				{
+					values.push_back(channel / 255.0f);
+				}
+			}
+			glUniform3fv(glGetUniformLocation(program, name), count, values.data());
+		};
+		GetGLState().useProgram(program);
+		upload("u_outlines", palette.outlines.data(), Shape::colourCount);
+		upload("u_fills", palette.fills.data(), Shape::colourCount);
+		upload("u_frames", palette.frames.data(), Shape::statusCount);
+	}
+}
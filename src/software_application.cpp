@@ -0,0 +1,51 @@
+#include "software_application.hpp"
+#include "exception.hpp"
+#include "software_renderer.hpp"
+#include "frame_capture.hpp"
+#include "game_logic.hpp"
+#include "profiler.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+namespace opengles_workspace
+{
+SoftwareApplication::SoftwareApplication(size_t width, size_t height, AppOptions options)
+	: mWidth(width)
+	, mHeight(height)
+	, mOptions(std::move(options))
+{
+	if (mOptions.hasSeed) {
+		Shape::SeedRandom(mOptions.seed);
+		// Constructing the game logic deals a new board from the seeded generator
+		GameLogic game;
+	}
+}
+
+int SoftwareApplication::run() {
+	AssetLoader assets(mOptions.palettePath);
+	SoftwareRenderer renderer((int)mWidth, (int)mHeight, assets);
+
+	double renderMs = 0.0;
+	for (int frame = 0; frame < mOptions.frames; frame++) {
+		PROFILE_ZONE("frame");
+		if (frame > 0) {
+			GameLogic::PlayScriptedFrame(frame);
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		renderer.render(GameLogic::GetSnapshot());
+		renderMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		if (!mOptions.captureDir.empty()) {
+			std::string path = mOptions.captureDir + "/frame_" + std::to_string(frame) + ".png";
+			if (!WritePng(path, renderer.width(), renderer.height(), renderer.pixels(), false)) {
+				throw Exception("Failed to write frame to " + path);
+			}
+		}
+	}
+	printf("Composited %d software frames in %.2f ms (%.3f ms/frame)\n",
+		mOptions.frames, renderMs, mOptions.frames ? renderMs / mOptions.frames : 0.0);
+	return 0;
+}
+}
\ No newline at end of file
@@ -0,0 +1,332 @@
+#include <software_renderer.hpp>
+#include <profiler.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SOFTWARE_RENDERER_SSE2
+#endif
+
+namespace opengles_workspace
+{
+	// Width & height of the baked shape & frame masks, scaled to the cell size when the tiles are built
+	const int shapeTileSize = 64;
+
+	static uint32_t PackRGBA(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+	{
+		unsigned char bytes[4] = { r, g, b, a };
+		uint32_t pixel;
+		memcpy(&pixel, bytes, sizeof(pixel));
+		return pixel;
+	}
+
+	/// @brief Fill a row of pixels with one value
+	/// @param destination first pixel
+	/// @param value packed RGBA value
+	/// @param count number of pixels
+	static void FillRow(uint32_t* destination, uint32_t value, int count)
+	{
+		int pixel = 0;
+#ifdef SOFTWARE_RENDERER_SSE2
+		__m128i values = _mm_set1_epi32((int)value);
+		for(; pixel + 4 <= count; pixel += 4)
+		{
+			_mm_storeu_si128((__m128i*)(destination + pixel), values);
+		}
+#endif
+		for(; pixel < count; pixel++)
+		{
+			destination[pixel] = value;
+		}
+	}
+
+	/// @brief Copy a row of opaque pixels
+	/// @param destination first destination pixel
+	/// @param source first source pixel
+	/// @param count number of pixels
+	static void CopyRow(uint32_t* destination, const uint32_t* source, int count)
+	{
+		int pixel = 0;
+#ifdef SOFTWARE_RENDERER_SSE2
+		for(; pixel + 8 <= count; pixel += 8)
+		{
+			__m128i first = _mm_loadu_si128((const __m128i*)(source + pixel));
+			__m128i second = _mm_loadu_si128((const __m128i*)(source + pixel + 4));
+			_mm_storeu_si128((__m128i*)(destination + pixel), first);
+			_mm_storeu_si128((__m128i*)(destination + pixel + 4), second);
+		}
+#endif
+		for(; pixel < count; pixel++)
+		{
+			destination[pixel] = source[pixel];
+		}
+	}
+
+	/// @brief Blend one colour over a row of pixels, weighted by glyph coverage
+	/// @param destination first destination pixel
+	/// @param coverage one coverage byte per pixel
+	/// @param colour packed RGBA colour
+	/// @param count number of pixels
+	static void BlendRow(uint32_t* destination, const unsigned char* coverage, uint32_t colour, int count)
+	{
+		int pixel = 0;
+#ifdef SOFTWARE_RENDERER_SSE2
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i full = _mm_set1_epi16(255);
+		const __m128i half = _mm_set1_epi16(128);
+		const __m128i colours = _mm_set1_epi32((int)colour);
+		const __m128i coloursLow = _mm_unpacklo_epi8(colours, zero);
+		for(; pixel + 4 <= count; pixel += 4)
+		{
+			uint32_t alphas;
+			memcpy(&alphas, coverage + pixel, sizeof(alphas));
+			if(alphas == 0)
+			{
+				continue;
+			}
+			if(alphas == 0xFFFFFFFFu)
+			{
+				_mm_storeu_si128((__m128i*)(destination + pixel), colours);
+				continue;
+			}
+
+			// Spread every coverage byte over the four channels of its pixel, widened to 16 bits
+			__m128i alpha = _mm_cvtsi32_si128((int)alphas);
+			alpha = _mm_unpacklo_epi8(alpha, alpha);
+			alpha = _mm_unpacklo_epi16(alpha, alpha);
+			__m128i alphaLow = _mm_unpacklo_epi8(alpha, zero);
+			__m128i alphaHigh = _mm_unpackhi_epi8(alpha, zero);
+
+			__m128i pixels = _mm_loadu_si128((const __m128i*)(destination + pixel));
+			__m128i pixelsLow = _mm_unpacklo_epi8(pixels, zero);
+			__m128i pixelsHigh = _mm_unpackhi_epi8(pixels, zero);
+
+			// destination * (255 - alpha) + colour * alpha, then a rounded division by 255
+			__m128i low = _mm_add_epi16(_mm_mullo_epi16(pixelsLow, _mm_sub_epi16(full, alphaLow)), _mm_mullo_epi16(coloursLow, alphaLow));
+			__m128i high = _mm_add_epi16(_mm_mullo_epi16(pixelsHigh, _mm_sub_epi16(full, alphaHigh)), _mm_mullo_epi16(coloursLow, alphaHigh));
+			low = _mm_add_epi16(low, half);
+			high = _mm_add_epi16(high, half);
+			low = _mm_srli_epi16(_mm_add_epi16(low, _mm_srli_epi16(low, 8)), 8);
+			high = _mm_srli_epi16(_mm_add_epi16(high, _mm_srli_epi16(high, 8)), 8);
+
+			_mm_storeu_si128((__m128i*)(destination + pixel), _mm_packus_epi16(low, high));
+		}
+#endif
+		for(; pixel < count; pixel++)
+		{
+			unsigned int alpha = coverage[pixel];
+			if(alpha == 0)
+			{
+				continue;
+			}
+			unsigned char channels[4];
+			unsigned char colourChannels[4];
+			memcpy(channels, &destination[pixel], sizeof(channels));
+			memcpy(colourChannels, &colour, sizeof(colourChannels));
+			for(int channel = 0; channel < 4; channel++)
+			{
+				unsigned int value = channels[channel] * (255 - alpha) + colourChannels[channel] * alpha + 128;
+				channels[channel] = (unsigned char)((value + (value >> 8)) >> 8);
+			}
+			memcpy(&destination[pixel], channels, sizeof(channels));
+		}
+	}
+
+	SoftwareRenderer::SoftwareRenderer(int width, int height, AssetLoader& assets)
+		: mWidth(width)
+		, mHeight(height)
+		, mPixels((size_t)width * height * 4)
+		, mLibrary(nullptr)
+		, mFace(nullptr)
+	{
+		mLayout.resize({ width, height, 1.0f });
+		mTileWidth = mLayout.cellPixels();
+		mTileHeight = mLayout.cellPixels();
+		loadTiles(assets);
+
+		// Init FreeType
+		AssetFile font = assets.font();
+		if(FT_Init_FreeType(&mLibrary))
+		{
+			fprintf(stderr, "Could not init freetype library\n");
+		}
+		// Load font as FT_Face
+		else if(!font.data || FT_New_Memory_Face(mLibrary, font.data, (FT_Long)font.size, 0, &mFace))
+		{
+			fprintf(stderr, "Could not open font\n");
+			mFace = nullptr;
+		}
+		else
+		{
+			// Rasterise at the size the text is shown at, the GL text quads scale their glyphs to the same size
+			FT_Set_Pixel_Sizes(mFace, 0, (FT_UInt)mLayout.textPixelSize());
+		}
+	}
+
+	SoftwareRenderer::~SoftwareRenderer()
+	{
+		if(mFace)
+		{
+			FT_Done_Face(mFace);
+		}
+		if(mLibrary)
+		{
+			FT_Done_FreeType(mLibrary);
+		}
+	}
+
+	/// @brief Colour every colour & status pair from its masks & the palette, scaled to the cell size with nearest sampling
+	/// @param assets loader of the masks & the palette
+	void SoftwareRenderer::loadTiles(AssetLoader& assets)
+	{
+		const ShapePalette& palette = assets.palette();
+		auto usable = [](const TextureImage& image)
+		{
+			return !image.levels.empty() && image.levels[0].width == shapeTileSize && image.levels[0].height == shapeTileSize;
+		};
+		for(int layer = 0; layer < Shape::textureLayerCount; layer++)
+		{
+			std::vector<uint32_t>& tile = mTiles[layer];
+			tile.assign((size_t)mTileWidth * mTileHeight, PackRGBA(0, 0, 0, 255));
+
+			const TextureImage& shapeMask = assets.maskImage(layer / Shape::statusCount);
+			const TextureImage& frameMask = assets.maskImage(Shape::colourCount + layer % Shape::statusCount);
+			if (!usable(shapeMask) || !usable(frameMask))
+			{
+				printf("Masks of layer %d are missing or not %dx%d\n", layer, shapeTileSize, shapeTileSize);
+				continue;
+			}
+			for(int row = 0; row < mTileHeight; row++)
+			{
+				size_t sourceRow = (size_t)((2 * row + 1) * shapeTileSize / (2 * mTileHeight)) * shapeTileSize;
+				for(int column = 0; column < mTileWidth; column++)
+				{
+					size_t texel = sourceRow + (2 * column + 1) * shapeTileSize / (2 * mTileWidth);
+					PaletteColour colour = palette.colour(layer, shapeMask.levels[0].pixels[texel], frameMask.levels[0].pixels[texel]);
+					tile[row * mTileWidth + column] = PackRGBA(colour[0], colour[1], colour[2], 255);
+				}
+			}
+		}
+	}
+
+	/// @brief Get the coverage bitmap of a character, rasterising it on first use
+	/// @param charCode character to look up
+	/// @return Glyph bitmap (empty if it could not be loaded)
+	const SoftwareRenderer::GlyphBitmap& SoftwareRenderer::glyph(unsigned long charCode)
+	{
+		auto cached = mGlyphs.find(charCode);
+		if(cached != mGlyphs.end())
+		{
+			return cached->second;
+		}
+
+		GlyphBitmap& glyph = mGlyphs[charCode];
+		glyph.width = 0;
+		glyph.rows = 0;
+
+		// Load glyph of character
+		if(!mFace || FT_Load_Char(mFace, charCode, FT_LOAD_RENDER))
+		{
+			fprintf(stderr, "Could not load character '%lu'\n", charCode);
+			return glyph;
+		}
+		FT_Bitmap bitmap = mFace->glyph->bitmap;
+
+		glyph.width = bitmap.width;
+		glyph.rows = bitmap.rows;
+		glyph.coverage.resize((size_t)bitmap.width * bitmap.rows);
+		for(unsigned int row = 0; row < bitmap.rows; row++)
+		{
+			memcpy(&glyph.coverage[row * bitmap.width], bitmap.buffer + row * bitmap.pitch, bitmap.width);
+		}
+		return glyph;
+	}
+
+	/// @brief Convert a normalized device x coordinate to a pixel column
+	int SoftwareRenderer::ndcToColumn(float x) const
+	{
+		return (int)std::lround((x + 1.0f) * 0.5f * mWidth);
+	}
+
+	/// @brief Convert a normalized device y coordinate to a pixel row, counted from the top
+	int SoftwareRenderer::ndcToRow(float y) const
+	{
+		return (int)std::lround((1.0f - y) * 0.5f * mHeight);
+	}
+
+	/// @brief Blend text into the framebuffer with the same cell layout as the GL HUD text
+	/// @param text text to draw
+	/// @param x left edge of the first character cell
+	/// @param y top edge of the character cells
+	/// @param cellWidth width of one character cell
+	/// @param cellHeight height of one character cell
+	void SoftwareRenderer::drawText(const std::string& text, float x, float y, float cellWidth, float cellHeight)
+	{
+		const uint32_t textColour = PackRGBA(255, 0, 0, 255);
+		uint32_t* framebuffer = reinterpret_cast<uint32_t*>(mPixels.data());
+
+		float X = x;
+		for(unsigned char character : text)
+		{
+			const GlyphBitmap& bitmap = glyph(character);
+
+			// Center the bitmap in its cell, the bitmap is already at framebuffer scale
+			float bitmapWidth = bitmap.width * 2.0f / mWidth;
+			float bitmapHeight = bitmap.rows * 2.0f / mHeight;
+			int left = ndcToColumn(X + (cellWidth - bitmapWidth) / 2.0f);
+			int top = ndcToRow(y - (cellHeight - bitmapHeight) / 2.0f);
+			X += cellWidth;
+
+			int firstColumn = std::max(0, -left);
+			int lastColumn = std::min(bitmap.width, mWidth - left);
+			for(int row = std::max(0, -top); row < bitmap.rows && top + row < mHeight; row++)
+			{
+				if(firstColumn >= lastColumn)
+				{
+					break;
+				}
+				BlendRow(framebuffer + (size_t)(top + row) * mWidth + left + firstColumn,
+					&bitmap.coverage[(size_t)row * bitmap.width + firstColumn], textColour, lastColumn - firstColumn);
+			}
+		}
+	}
+
+	void SoftwareRenderer::render(const GameSnapshot& snapshot)
+	{
+		PROFILE_ZONE("software render");
+		uint32_t* framebuffer = reinterpret_cast<uint32_t*>(mPixels.data());
+		FillRow(framebuffer, PackRGBA(0, 0, 0, 255), mWidth * mHeight);
+
+		// Blit every cell from its pre-scaled tile, neighbouring cells share their rounded edges
+		for(int i = 0; i < GameLogic::gameBoardSize; i++)
+		{
+			int top = ndcToRow(mLayout.cellY(i));
+			int bottom = ndcToRow(mLayout.cellY(i + 1));
+			for(int j = 0; j < GameLogic::gameBoardSize; j++)
+			{
+				int left = ndcToColumn(mLayout.cellX(j));
+				int right = ndcToColumn(mLayout.cellX(j + 1));
+
+				const std::vector<uint32_t>& tile = mTiles[snapshot.GetTextureLayerAt(i, j)];
+				int firstColumn = std::max(left, 0);
+				int columns = std::min({ right, mWidth, left + mTileWidth }) - firstColumn;
+				if(columns <= 0)
+				{
+					continue;
+				}
+				for(int row = std::max(top, 0); row < bottom && row < mHeight && row - top < mTileHeight; row++)
+				{
+					CopyRow(framebuffer + (size_t)row * mWidth + firstColumn,
+						&tile[(size_t)(row - top) * mTileWidth + firstColumn - left], columns);
+				}
+			}
+		}
+
+		drawText(("SCORE-" + std::to_string(snapshot.score)).substr(0, Layout::maxHudLabelLength),
+			mLayout.scoreX(), mLayout.scoreY(), mLayout.cellWidth(), mLayout.cellHeight());
+	}
+}
@@ -0,0 +1,178 @@
+#include <sprite_batch.hpp>
+#include <geometry.hpp>
+#include <gl_extensions.hpp>
+#include <gl_state_cache.hpp>
+#include <profiler.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+namespace opengles_workspace
+{
+	// Waits longer than this are split up, a fence that never signals means a lost context
+	const GLuint64 fenceTimeoutNs = 1000000000;
+
+	SpriteBatch::SpriteBatch(int maxQuads, int regionCount)
+		: mMaxQuads(maxQuads)
+		, mRegionCount(regionCount)
+		, mRegion(regionCount - 1)
+		, mVertices(nullptr)
+		, mQuadCount(0)
+		, mFences(regionCount, nullptr)
+	{
+		// 16 bit indices address at most 65536 vertices
+		assert(maxQuads * regionCount * 4 <= 65536);
+
+		glGenVertexArrays(1, &mVao);
+		GetGLState().bindVertexArray(mVao);
+
+		glGenBuffers(1, &mVbo);
+		GetGLState().bindBuffer(GL_ARRAY_BUFFER, mVbo);
+		glBufferData(GL_ARRAY_BUFFER, maxQuads * regionCount * 4 * sizeof(SpriteVertex), nullptr, GL_STREAM_DRAW);
+
+		glVertexAttribPointer ( 0, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, x) );
+		GetGLState().enableVertexAttribArray(0);
+		glVertexAttribPointer ( 2, 3, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, u) );
+		GetGLState().enableVertexAttribArray(2);
+
+		// The element buffer binding is part of the vertex array state, draws pick their region by the first index
+		mIbo = CreateQuadIndexBuffer(maxQuads * regionCount);
+
+		GetGLState().bindVertexArray(0);
+		GetGLState().bindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	SpriteBatch::~SpriteBatch()
+	{
+		unmap();
+		const GLExtensions& extensions = GetGLExtensions();
+		for(int region = 0; region < mRegionCount; region++)
+		{
+			GLsync fence = mFences[region];
+			if(fence)
+			{
+				// Regions fenced together share the fence, it is deleted once
+				std::replace(mFences.begin(), mFences.end(), fence, (GLsync)nullptr);
+				extensions.DeleteSync(fence);
+			}
+		}
+		GetGLState().deleteBuffers(1, &mIbo);
+		GetGLState().deleteBuffers(1, &mVbo);
+		GetGLState().deleteVertexArrays(1, &mVao);
+	}
+
+	/// @brief Start a batch in the next region of the ring
+	void SpriteBatch::begin()
+	{
+		unmap();
+		mRegion = (mRegion + 1) % mRegionCount;
+		mQuadCount = 0;
+
+		const GLExtensions& extensions = GetGLExtensions();
+		GLsync fence = mFences[mRegion];
+		if(fence)
+		{
+			PROFILE_ZONE("sprite fence wait");
+			GLenum result = extensions.ClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, fenceTimeoutNs);
+			while(result == GL_TIMEOUT_EXPIRED)
+			{
+				result = extensions.ClientWaitSync(fence, 0, fenceTimeoutNs);
+			}
+			std::replace(mFences.begin(), mFences.end(), fence, (GLsync)nullptr);
+			extensions.DeleteSync(fence);
+		}
+
+		// Fenced regions are written without the driver tracking their use, without fences it has to keep them apart itself
+		GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT;
+		if(extensions.sync)
+		{
+			access |= GL_MAP_UNSYNCHRONIZED_BIT;
+		}
+		GetGLState().bindBuffer(GL_ARRAY_BUFFER, mVbo);
+		mVertices = (SpriteVertex*)glMapBufferRange(GL_ARRAY_BUFFER, mRegion * mMaxQuads * 4 * sizeof(SpriteVertex),
+			mMaxQuads * 4 * sizeof(SpriteVertex), access);
+	}
+
+	/// @brief Append a quad to the current batch
+	/// @param leftX left edge
+	/// @param topY top edge
+	/// @param rightX right edge
+	/// @param bottomY bottom edge
+	/// @param leftU texture coordinate of the left edge
+	/// @param topV texture coordinate of the top edge
+	/// @param rightU texture coordinate of the right edge
+	/// @param bottomV texture coordinate of the bottom edge
+	/// @param layer texture array layer
+	/// @return false if the batch is full or not mapped, the quad is dropped
+	bool SpriteBatch::addQuad(float leftX, float topY, float rightX, float bottomY,
+		float leftU, float topV, float rightU, float bottomV, float layer)
+	{
+		if(!mVertices || mQuadCount >= mMaxQuads)
+		{
+			return false;
+		}
+		SpriteVertex* quad = mVertices + mQuadCount * 4;
+		quad[0] = { leftX,	topY,		leftU,	topV,		layer };	// Top left
+		quad[1] = { rightX,	topY,		rightU,	topV,		layer };	// Top right
+		quad[2] = { leftX,	bottomY,	leftU,	bottomV,	layer };	// Bottom left
+		quad[3] = { rightX,	bottomY,	rightU,	bottomV,	layer };	// Bottom right
+		mQuadCount++;
+		return true;
+	}
+
+	/// @brief Finish the batch & record its draw
+	/// @param commands command buffer of the current frame
+	/// @param layer render layer of the draw
+	/// @param uniformCount uniforms the caller fills in
+	/// @return Draw command with the geometry set, null if no quad was added
+	DrawCommand* SpriteBatch::record(RenderCommandBuffer& commands, RenderLayer layer, uint32_t uniformCount)
+	{
+		unmap();
+		if(mQuadCount == 0)
+		{
+			return nullptr;
+		}
+		mUnfencedRegions.push_back(mRegion);
+
+		DrawCommand& command = commands.addDraw(layer, uniformCount);
+		command.vertexArray = mVao;
+		command.mode = GL_TRIANGLES;
+		command.count = mQuadCount * 6;
+		command.first = mRegion * mMaxQuads * 6;
+		return &command;
+	}
+
+	/// @brief Insert one fence behind the draws of every batch recorded since the last call
+	void SpriteBatch::fence()
+	{
+		const GLExtensions& extensions = GetGLExtensions();
+		if(!extensions.sync || mUnfencedRegions.empty())
+		{
+			mUnfencedRegions.clear();
+			return;
+		}
+		GLsync fence = extensions.FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		for(int region : mUnfencedRegions)
+		{
+			mFences[region] = fence;
+		}
+		mUnfencedRegions.clear();
+	}
+
+	/// @brief Flush only the quads written & release the mapping, a draw must never read a mapped buffer
+	void SpriteBatch::unmap()
+	{
+		if(!mVertices)
+		{
+			return;
+		}
+		GetGLState().bindBuffer(GL_ARRAY_BUFFER, mVbo);
+		if(mQuadCount > 0)
+		{
+			glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, mQuadCount * 4 * sizeof(SpriteVertex));
+		}
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+		mVertices = nullptr;
+	}
+}
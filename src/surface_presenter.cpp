@@ -0,0 +1,100 @@
+#include <surface_presenter.hpp>
+
+#include <cstring>
+
+#include <glad/egl.h>
+
+// EGL_EXT_buffer_age
+#define EGL_BUFFER_AGE_EXT 0x313D
+
+namespace opengles_workspace
+{
+	// Same signature for EGL_KHR_swap_buffers_with_damage & EGL_EXT_swap_buffers_with_damage
+	typedef EGLBoolean (*PFNEGLSWAPBUFFERSWITHDAMAGEPROC)(EGLDisplay dpy, EGLSurface surface, const EGLint* rects, EGLint n_rects);
+
+	static bool HasExtension(const char* extensions, const char* name)
+	{
+		size_t length = strlen(name);
+		for(const char* found = strstr(extensions, name); found; found = strstr(found + length, name))
+		{
+			bool startsWord = found == extensions || found[-1] == ' ';
+			bool endsWord = found[length] == ' ' || found[length] == '\0';
+			if(startsWord && endsWord)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	SurfacePresenter::SurfacePresenter(GLFWwindow* window)
+		: mWindow(window)
+		, mDisplay(EGL_NO_DISPLAY)
+		, mSurface(EGL_NO_SURFACE)
+		, mHasBufferAge(false)
+		, mSwapBuffersWithDamage(nullptr)
+	{
+		// Partial updates are only reachable when the current context was created through EGL
+		if(!gladLoaderLoadEGL(EGL_NO_DISPLAY))
+		{
+			return;
+		}
+		EGLDisplay display = eglGetCurrentDisplay();
+		EGLSurface surface = eglGetCurrentSurface(EGL_DRAW);
+		if(display == EGL_NO_DISPLAY || surface == EGL_NO_SURFACE || !gladLoaderLoadEGL(display))
+		{
+			return;
+		}
+		mDisplay = display;
+		mSurface = surface;
+
+		const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+		if(!extensions)
+		{
+			return;
+		}
+		mHasBufferAge = HasExtension(extensions, "EGL_EXT_buffer_age");
+		if(HasExtension(extensions, "EGL_KHR_swap_buffers_with_damage"))
+		{
+			mSwapBuffersWithDamage = (void*)eglGetProcAddress("eglSwapBuffersWithDamageKHR");
+		}
+		else if(HasExtension(extensions, "EGL_EXT_swap_buffers_with_damage"))
+		{
+			mSwapBuffersWithDamage = (void*)eglGetProcAddress("eglSwapBuffersWithDamageEXT");
+		}
+	}
+
+	int SurfacePresenter::bufferAge()
+	{
+		if(!mHasBufferAge)
+		{
+			return 0;
+		}
+		EGLint age = 0;
+		if(!eglQuerySurface(mDisplay, mSurface, EGL_BUFFER_AGE_EXT, &age))
+		{
+			return 0;
+		}
+		return age;
+	}
+
+	/// @brief Present the back buffer
+	/// @param damage rectangles that changed since the previous frame
+	void SurfacePresenter::present(const std::vector<DamageRect>& damage)
+	{
+		if(!mSwapBuffersWithDamage)
+		{
+			glfwSwapBuffers(mWindow);
+			return;
+		}
+
+		std::vector<EGLint> rects;
+		rects.reserve(damage.size() * 4);
+		for(const DamageRect& rect : damage)
+		{
+			rects.insert(rects.end(), { rect.x, rect.y, rect.width, rect.height });
+		}
+		auto swapBuffersWithDamage = (PFNEGLSWAPBUFFERSWITHDAMAGEPROC)mSwapBuffersWithDamage;
+		swapBuffersWithDamage(mDisplay, mSurface, rects.data(), (EGLint)damage.size());
+	}
+}
@@ -0,0 +1,264 @@
+#include <tile_map_renderer.hpp>
+#include <exception.hpp>
+#include <geometry.hpp>
+#include <gl_state_cache.hpp>
+#include <shape_palette.hpp>
+
+#include <algorithm>
+#include <string>
+
+namespace opengles_workspace
+{
+	// Past this many changed cells in one update the whole map counts as changed
+	const size_t maxTrackedChanges = 1024;
+
+	char tileMapVShaderStr[] =
+		"#version 300 es \n"
+		"\n"
+		"layout(location = 0) in vec2 a_corner; \n"
+		"uniform vec2 u_origin; \n"
+		"uniform vec2 u_size; \n"
+		"uniform vec2 u_grid; \n"
+		"uniform vec4 u_viewport; \n"
+		"out highp vec2 v_cell; \n"
+		"\n"
+		"void main() \n"
+		"{ \n"
+		" vec2 position = u_origin + vec2(a_corner.x, -a_corner.y) * u_size; \n"
+		// Only the part of the map inside the viewport is rasterised, cells outside it never reach the fragment shader
+		" vec2 clipped = clamp(position, u_viewport.xy, u_viewport.zw); \n"
+		" gl_Position = vec4(clipped, 0.0, 1.0); \n"
+		" v_cell = (a_corner + (clipped - position) / u_size * vec2(1.0, -1.0)) * u_grid; \n"
+		"} \n";
+
+	static std::string TileMapFragmentShader()
+	{
+		return
+			"#version 300 es \n"
+			"precision highp float; \n"
+			"precision mediump sampler2DArray; \n"
+			"precision highp usampler2D; \n"
+			"\n"
+			"in highp vec2 v_cell; \n"
+			"out vec4 fragColor; \n"
+			"uniform sampler2DArray shapeMasks; \n"
+			"uniform usampler2D cellLayers; \n"
+			"uniform float u_flat; \n"
+			+ ShapePaletteShader() +
+			"\n"
+			"void main() \n"
+			"{ \n"
+			" ivec2 cell = min(ivec2(v_cell), textureSize(cellLayers, 0) - 1); \n"
+			" float pair = float(texelFetch(cellLayers, cell, 0).r); \n"
+			" ivec2 layers = CellMaskLayers(pair); \n"
+			// Cells of a few pixels take the average colour of their shape from the 1x1 mip levels
+			" if(u_flat > 0.0) \n"
+			" { \n"
+			"  float level = log2(float(textureSize(shapeMasks, 0).x)); \n"
+			"  fragColor = ColourCell(textureLod(shapeMasks, vec3(0.5, 0.5, layers.x), level).r, \n"
+			"   textureLod(shapeMasks, vec3(0.5, 0.5, layers.y), level).r, pair); \n"
+			"  return; \n"
+			" } \n"
+			// The mip level comes from the gradients of the continuous cell coordinate, those of fract jump at cell edges & would pick the 1x1 level there
+			" vec2 dx = dFdx(v_cell); \n"
+			" vec2 dy = dFdy(v_cell); \n"
+			" fragColor = ColourCell(textureGrad(shapeMasks, vec3(fract(v_cell), layers.x), dx, dy).r, \n"
+			"  textureGrad(shapeMasks, vec3(fract(v_cell), layers.y), dx, dy).r, pair); \n"
+			"} \n";
+	}
+
+	TileMapRenderer::TileMapRenderer(ShaderManager& shaders, GLuint shapeMasks, const ShapePalette& palette, int columns, int rows)
+		: mColumns(columns)
+		, mRows(rows)
+		, mShapeMasks(shapeMasks)
+		, mLeftX(-1.0f)
+		, mTopY(1.0f)
+		, mWidth(2.0f)
+		, mHeight(2.0f)
+		, mViewport({ -1.0f, -1.0f, 1.0f, 1.0f })
+		, mFlat(false)
+		, mCells((size_t)columns * rows, 0)
+		, mDirtyLeft(0)
+		, mDirtyTop(0)
+		, mDirtyRight(0)
+		, mDirtyBottom(0)
+		, mAllChanged(false)
+	{
+		GLint maxTextureSize = 0;
+		glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+		if(columns <= 0 || rows <= 0 || columns > maxTextureSize || rows > maxTextureSize)
+		{
+			throw Exception("Tile map of " + std::to_string(columns) + "x" + std::to_string(rows)
+				+ " cells does not fit a " + std::to_string(maxTextureSize) + " texture");
+		}
+
+		std::string fShaderStr = TileMapFragmentShader();
+		mProgram = shaders.createProgram(tileMapVShaderStr, fShaderStr.c_str());
+		mOriginLocation = glGetUniformLocation(mProgram, "u_origin");
+		mSizeLocation = glGetUniformLocation(mProgram, "u_size");
+		mGridLocation = glGetUniformLocation(mProgram, "u_grid");
+		mViewportLocation = glGetUniformLocation(mProgram, "u_viewport");
+		mFlatLocation = glGetUniformLocation(mProgram, "u_flat");
+		// The mask array is bound as the draw texture on unit 0, the cell layers as the lookup texture on unit 1
+		SetShapePaletteUniforms(mProgram, palette);
+		glUniform1i(glGetUniformLocation(mProgram, "shapeMasks"), 0);
+		glUniform1i(glGetUniformLocation(mProgram, "cellLayers"), 1);
+		GetGLState().useProgram(0);
+
+		// One texel per cell holding its colour & status pair, integer textures are never filtered
+		glGenTextures(1, &mIndexTexture);
+		GetGLState().bindTexture(0, GL_TEXTURE_2D, mIndexTexture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, columns, rows, 0, GL_RED_INTEGER, GL_UNSIGNED_BYTE, mCells.data());
+		GetGLState().bindTexture(0, GL_TEXTURE_2D, 0);
+
+		// Static unit quad, corners in 0..1 from the top left of the map
+		GLfloat corners[] = 	{
+								 0.0f, 0.0f,		// Top left
+								 1.0f, 0.0f,		// Top right
+								 0.0f, 1.0f,		// Bottom left
+								 1.0f, 1.0f		// Bottom right
+								};
+		glGenVertexArrays(1, &mQuadVao);
+		GetGLState().bindVertexArray(mQuadVao);
+		glGenBuffers(1, &mQuadVbo);
+		GetGLState().bindBuffer(GL_ARRAY_BUFFER, mQuadVbo);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+		glVertexAttribPointer ( 0, 2, GL_FLOAT, GL_FALSE, 0, nullptr );
+		GetGLState().enableVertexAttribArray(0);
+		mQuadIbo = CreateQuadIndexBuffer(1);
+		GetGLState().bindVertexArray(0);
+		GetGLState().bindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	TileMapRenderer::~TileMapRenderer()
+	{
+		GetGLState().deleteTextures(1, &mIndexTexture);
+		GetGLState().deleteBuffers(1, &mQuadIbo);
+		GetGLState().deleteBuffers(1, &mQuadVbo);
+		GetGLState().deleteVertexArrays(1, &mQuadVao);
+	}
+
+	/// @brief Store the layer of a cell & grow the dirty rectangle around it, unchanged cells cost nothing
+	/// @param row cell row, 0 at the top
+	/// @param column cell column, 0 at the left
+	/// @param layer colour & status pair, as reported by Shape::GetTextureLayer
+	void TileMapRenderer::setCell(int row, int column, uint8_t layer)
+	{
+		int cell = row * mColumns + column;
+		if(mCells[cell] == layer)
+		{
+			return;
+		}
+		mCells[cell] = layer;
+
+		if(mDirtyRight <= mDirtyLeft)
+		{
+			mDirtyLeft = column;
+			mDirtyTop = row;
+			mDirtyRight = column + 1;
+			mDirtyBottom = row + 1;
+		}
+		else
+		{
+			mDirtyLeft = std::min(mDirtyLeft, column);
+			mDirtyTop = std::min(mDirtyTop, row);
+			mDirtyRight = std::max(mDirtyRight, column + 1);
+			mDirtyBottom = std::max(mDirtyBottom, row + 1);
+		}
+
+		if(!mAllChanged && mChangedCells.size() < maxTrackedChanges)
+		{
+			mChangedCells.push_back(cell);
+		}
+		else if(!mAllChanged)
+		{
+			mChangedCells.clear();
+			mAllChanged = true;
+		}
+	}
+
+	/// @brief Upload the dirty rectangle straight out of the cell copy with a single glTexSubImage2D
+	void TileMapRenderer::flush()
+	{
+		if(mDirtyRight <= mDirtyLeft)
+		{
+			return;
+		}
+
+		GetGLState().bindTexture(0, GL_TEXTURE_2D, mIndexTexture);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		// Rows of the rectangle are strided by the width of the whole map
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, mColumns);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, mDirtyLeft, mDirtyTop, mDirtyRight - mDirtyLeft, mDirtyBottom - mDirtyTop,
+			GL_RED_INTEGER, GL_UNSIGNED_BYTE, &mCells[(size_t)mDirtyTop * mColumns + mDirtyLeft]);
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		mDirtyLeft = mDirtyTop = mDirtyRight = mDirtyBottom = 0;
+	}
+
+	/// @brief Place the map
+	/// @param leftX left edge in normalized device coordinates
+	/// @param topY top edge in normalized device coordinates
+	/// @param width width in normalized device coordinates
+	/// @param height height in normalized device coordinates
+	void TileMapRenderer::setBounds(float leftX, float topY, float width, float height)
+	{
+		mLeftX = leftX;
+		mTopY = topY;
+		mWidth = width;
+		mHeight = height;
+	}
+
+	/// @brief Clip the map to a rectangle, everything outside it is culled
+	/// @param leftX left edge in normalized device coordinates
+	/// @param topY top edge in normalized device coordinates
+	/// @param rightX right edge in normalized device coordinates
+	/// @param bottomY bottom edge in normalized device coordinates
+	void TileMapRenderer::setViewport(float leftX, float topY, float rightX, float bottomY)
+	{
+		mViewport = { leftX, bottomY, rightX, topY };
+	}
+
+	/// @brief Refresh the index texture from the game board, only changed cells are uploaded
+	/// @param snapshot game state to draw
+	/// @param layout placement of the board cells through the camera
+	void TileMapRenderer::update(const GameSnapshot& snapshot, const Layout& layout)
+	{
+		mChangedCells.clear();
+		mAllChanged = false;
+		for(int row = 0; row < mRows && row < GameLogic::gameBoardSize; row++)
+		{
+			for(int column = 0; column < mColumns && column < GameLogic::gameBoardSize; column++)
+			{
+				setCell(row, column, (uint8_t)snapshot.GetTextureLayerAt(row, column));
+			}
+		}
+		setBounds(layout.cellX(0), layout.cellY(0), layout.tileWidth() * mColumns, layout.tileHeight() * mRows);
+		setViewport(layout.boardLeft(), layout.boardTop(), layout.boardRight(), layout.boardBottom());
+		setFlat(layout.flatTiles());
+		flush();
+	}
+
+	/// @brief Record the map draw
+	/// @param commands command buffer of the current frame
+	void TileMapRenderer::record(RenderCommandBuffer& commands)
+	{
+		DrawCommand& command = commands.addDraw(RenderLayer::BOARD, 5);
+		command.program = mProgram;
+		command.textureTarget = GL_TEXTURE_2D_ARRAY;
+		command.texture = mShapeMasks;
+		command.lookupTexture = mIndexTexture;
+		command.vertexArray = mQuadVao;
+		command.mode = GL_TRIANGLES;
+		command.count = 6;
+		command.uniforms[0] = { mOriginLocation, 2, { mLeftX, mTopY } };
+		command.uniforms[1] = { mSizeLocation, 2, { mWidth, mHeight } };
+		command.uniforms[2] = { mGridLocation, 2, { (float)mColumns, (float)mRows } };
+		command.uniforms[3] = { mViewportLocation, 4, { mViewport[0], mViewport[1], mViewport[2], mViewport[3] } };
+		command.uniforms[4] = { mFlatLocation, 1, { mFlat ? 1.0f : 0.0f } };
+	}
+}
@@ -0,0 +1,48 @@
+#include <baked_texture.hpp>
+
+#include <cstdio>
+#include <string>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+using namespace opengles_workspace;
+
+// Bakes images into 8-bit containers with precomputed mip chains: asset_baker <output directory> <image>...
+// Greyscale images stay single channel, anything else becomes RGBA
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: %s <output directory> <image>...\n", argv[0]);
+        return 1;
+    }
+
+    std::string outputDirectory = argv[1];
+    int failures = 0;
+    for (int i = 2; i < argc; i++)
+    {
+        std::string input = argv[i];
+        size_t nameStart = input.find_last_of("/\\");
+        nameStart = nameStart == std::string::npos ? 0 : nameStart + 1;
+        std::string name = input.substr(nameStart, input.find_last_of('.') - nameStart);
+        std::string output = outputDirectory + "/" + name + ".tex";
+
+        int width, height, nrChannels;
+        int channels = stbi_info(input.c_str(), &width, &height, &nrChannels) && nrChannels <= 2 ? 1 : 4;
+        unsigned char* data = stbi_load(input.c_str(), &width, &height, &nrChannels, channels);
+        if (!data)
+        {
+            fprintf(stderr, "Failed to load image at [%s]\n", input.c_str());
+            failures++;
+            continue;
+        }
+        if (!WriteBakedTexture(output, width, height, channels, data))
+        {
+            fprintf(stderr, "Failed to write baked texture [%s]\n", output.c_str());
+            failures++;
+        }
+        stbi_image_free(data);
+    }
+    return failures ? 1 : 0;
+}